@@ -0,0 +1,140 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        addressindex.h
+ * \brief       Header file declaring an index for looking up symbols by
+ *              address
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares an index that maps addresses to the symbols
+ * containing them, e.g. for symbolizing return addresses.
+ */
+
+#ifndef LIBELFPP_ADDRESSINDEX_H
+#define LIBELFPP_ADDRESSINDEX_H
+
+#include "section.h"
+#include <memory>
+#include <vector>
+
+namespace libelfpp {
+
+/// Index for looking up the symbol that contains an address. Holds the
+/// defined symbols of the selected types of all given symbol sections sorted
+/// by address. If several symbols start at the same address (aliases, or the
+/// same symbol in \p .symtab and \p .dynsym), lookups prefer global over weak
+/// over local symbols. If symbols are nested, lookups return the containing
+/// symbol with the highest start address, e.g. the inner symbol for addresses
+/// within it and the outer symbol for addresses behind it.
+class SymbolAddressIndex final {
+
+private:
+  /// Keeps the symbol sections, and so the names of the symbols, alive
+  std::vector<std::shared_ptr<SymbolSection>> Sections;
+  /// All indexed symbols sorted by address
+  std::vector<IndexedSymbol> Entries;
+  /// For every entry the index of the closest preceding entry that reaches
+  /// beyond its start plus one, 0 if there is none
+  std::vector<std::size_t> Enclosing;
+
+  /// Returns the best symbol starting at the address of \p first that
+  /// contains \p address.
+  ///
+  /// \param first The first entry with that address
+  /// \param address The address to look up
+  /// \return The symbol or \p nullptr if none contains \p address
+  const IndexedSymbol* findAt(std::vector<IndexedSymbol>::const_iterator first,
+                              Elf64_Addr address) const;
+
+  /// Returns the best symbol containing \p address, starting with the
+  /// symbols at the address of \p first and continuing with the symbols
+  /// enclosing them.
+  ///
+  /// \param first The first entry of the last address at or before
+  ///        \p address
+  /// \param address The address to look up
+  /// \return The symbol or \p nullptr if none contains \p address
+  const IndexedSymbol* findFrom(std::vector<IndexedSymbol>::const_iterator first,
+                                Elf64_Addr address) const;
+
+public:
+  /// Symbol types indexed by default: functions, indirect functions and
+  /// objects. Other types can be selected by passing a mask of
+  /// (1 << \p STT_...) values.
+  static const unsigned int DefaultTypes = (1u << STT_FUNC) | (1u << STT_GNU_IFUNC) |
+                                           (1u << STT_OBJECT);
+
+  /// Constructor of \p SymbolAddressIndex. Indexes all defined symbols of the
+  /// given sections whose type is in \p types.
+  ///
+  /// \param sections The symbol sections to index
+  /// \param types Mask of symbol types to index
+  explicit SymbolAddressIndex(const std::vector<std::shared_ptr<SymbolSection>>& sections,
+                              unsigned int types = DefaultTypes);
+
+  /// Returns all indexed symbols sorted by address.
+  ///
+  /// \return Reference to the indexed symbols
+  const std::vector<IndexedSymbol>& getEntries() const {
+    return Entries;
+  }
+
+  /// Returns for every entry the index of the closest preceding entry whose
+  /// symbol reaches beyond the start of the entry's symbol, plus one, or 0
+  /// if there is none. Following these links from an entry visits all
+  /// symbols that may enclose it.
+  ///
+  /// \return Reference to the links, one per entry
+  const std::vector<std::size_t>& getEnclosing() const {
+    return Enclosing;
+  }
+
+  /// Returns the symbol that contains an address in O(log n).
+  ///
+  /// \param address The address to look up
+  /// \return Pointer to the symbol or \p nullptr if no symbol contains it
+  const IndexedSymbol* find(Elf64_Addr address) const;
+
+  /// Looks up many addresses in one pass over the index. The addresses must
+  /// be sorted in ascending order.
+  ///
+  /// \param addresses Sorted addresses to look up
+  /// \return For every address a pointer to the symbol containing it or
+  ///         \p nullptr
+  std::vector<const IndexedSymbol*> findAll(const std::vector<Elf64_Addr>& addresses) const;
+
+  /// Returns all symbols with the same address and size as \p entry,
+  /// including \p entry itself.
+  ///
+  /// \param entry An entry of this index
+  /// \return Pointers to the aliases of \p entry
+  std::vector<const IndexedSymbol*> getAliases(const IndexedSymbol& entry) const;
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_ADDRESSINDEX_H
@@ -0,0 +1,137 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        corpus.h
+ * \brief       Header file declaring a loader for many ELF files at once
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares a class that opens and parses a corpus of ELF
+ * files, e.g. all files of a container image, on a pool of threads.
+ */
+
+#ifndef LIBELFPP_CORPUS_H
+#define LIBELFPP_CORPUS_H
+
+#include "libelfpp.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libelfpp {
+
+/// Options of a \p CorpusLoader
+struct CorpusOptions final {
+  /// Number of threads loading files, 0 for one per hardware thread
+  unsigned int Threads;
+  /// Maximum number of files being loaded or waiting for the callback at the
+  /// same time, 0 for twice the number of threads
+  std::size_t MaxInFlight;
+  /// Strategy the files are loaded with. Mapping the files only reads their
+  /// headers, so it is the default.
+  LoadMode Mode;
+
+  /// Constructor of \p CorpusOptions. Sets the defaults.
+  CorpusOptions() : Threads(0), MaxInFlight(0), Mode(LoadMode::Map) {}
+};
+
+/// Result of loading a single file of a corpus
+struct CorpusResult final {
+  /// Position of the file in the list of paths
+  std::size_t Index;
+  /// Path of the file
+  std::string Path;
+  /// The loaded file or \p nullptr if loading failed
+  std::shared_ptr<ELFFile> File;
+  /// Message of the error loading the file, empty on success
+  std::string Error;
+
+  /// Returns \p true if the file was loaded.
+  explicit operator bool() const {
+    return File != nullptr;
+  }
+};
+
+/// Loads many ELF files on a pool of threads. Every thread starts with a
+/// contiguous block of the files and steals files from the end of the blocks
+/// of other threads once its own block is done, so a few large files do not
+/// hold up the whole batch. Results are passed to a callback on the calling
+/// thread in the order the files complete. Since a file stays in flight until
+/// the callback returns, the number of loaded files held by the loader is
+/// bounded by \p CorpusOptions::MaxInFlight.
+class CorpusLoader final {
+
+public:
+  /// Type of the callback receiving the results
+  typedef std::function<void(const CorpusResult&)> Callback;
+
+private:
+  /// The options
+  CorpusOptions Options;
+
+public:
+  /// Constructor of \p CorpusLoader.
+  ///
+  /// \param options The options
+  explicit CorpusLoader(const CorpusOptions& options = CorpusOptions()) : Options(options) {}
+
+  /// Returns the options.
+  const CorpusOptions& getOptions() const {
+    return Options;
+  }
+
+  /// Loads the files and passes a result for every file to \p callback,
+  /// including those that could not be loaded. Returns when all results have
+  /// been passed. If the callback throws, no further files are started and
+  /// the exception is rethrown once the threads have stopped.
+  ///
+  /// \param paths Paths of the files
+  /// \param callback Receives the results, called on the calling thread
+  void load(const std::vector<std::string>& paths, const Callback& callback) const;
+
+  /// Loads all regular files in a directory and its subdirectories, see
+  /// \p load.
+  ///
+  /// \param directory Path of the directory
+  /// \param callback Receives the results, called on the calling thread
+  /// \throws std::runtime_error If the directory can not be read
+  void loadDirectory(const std::string& directory, const Callback& callback) const;
+
+  /// Returns the paths of all regular files in a directory and its
+  /// subdirectories, sorted by path. Symbolic links are not followed and
+  /// subdirectories that can not be read are skipped.
+  ///
+  /// \param directory Path of the directory
+  /// \return Paths of the files
+  /// \throws std::runtime_error If the directory can not be read
+  static std::vector<std::string> findFiles(const std::string& directory);
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_CORPUS_H
@@ -0,0 +1,672 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        elfview.h
+ * \brief       Header file declaring light-weight views on the raw structures
+ *              of an ELF image
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares templated views on the headers, symbols,
+ * relocations and dynamic entries of an ELF image in memory. Class and
+ * encoding of the image are template parameters, so all accessors are inline
+ * and decode their fields without virtual calls or runtime checks. The views
+ * do not own or copy any data.
+ *
+ * The polymorphic classes of the library decode their entries with the same
+ * views, using the runtime \p EndianessConverter instead of
+ * \p StaticEndianessConverter.
+ */
+
+#ifndef LIBELFPP_ELFVIEW_H
+#define LIBELFPP_ELFVIEW_H
+
+#include "endianutil.h"
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <elf.h>
+
+namespace libelfpp {
+
+/// Types of the structures of an ELF class, selected by the type of the file
+/// header.
+///
+/// \tparam T The type of ELF header
+template<class T>
+struct ELFClassTypes;
+
+/// Structure types of 32 Bit ELFs
+template<>
+struct ELFClassTypes<Elf32_Ehdr> {
+  /// Defines the type of the file header
+  typedef Elf32_Ehdr Ehdr_t;
+  /// Defines the type of program headers
+  typedef Elf32_Phdr Phdr_t;
+  /// Defines the type of section headers
+  typedef Elf32_Shdr Shdr_t;
+  /// Defines the type of symbols
+  typedef Elf32_Sym Sym_t;
+  /// Defines the type of relocations without addend
+  typedef Elf32_Rel Rel_t;
+  /// Defines the type of relocations with addend
+  typedef Elf32_Rela Rela_t;
+  /// Defines the type of dynamic entries
+  typedef Elf32_Dyn Dyn_t;
+  /// Holds the class
+  static const bool is64Bit = false;
+};
+
+/// Structure types of 64 Bit ELFs
+template<>
+struct ELFClassTypes<Elf64_Ehdr> {
+  /// Defines the type of the file header
+  typedef Elf64_Ehdr Ehdr_t;
+  /// Defines the type of program headers
+  typedef Elf64_Phdr Phdr_t;
+  /// Defines the type of section headers
+  typedef Elf64_Shdr Shdr_t;
+  /// Defines the type of symbols
+  typedef Elf64_Sym Sym_t;
+  /// Defines the type of relocations without addend
+  typedef Elf64_Rel Rel_t;
+  /// Defines the type of relocations with addend
+  typedef Elf64_Rela Rela_t;
+  /// Defines the type of dynamic entries
+  typedef Elf64_Dyn Dyn_t;
+  /// Holds the class
+  static const bool is64Bit = true;
+};
+
+
+/// Template for retrieving type and symbol of a relocation entry
+template<typename T> struct getSymbolAndType;
+
+/// Specialized template for 32 Bit relocation
+template<>
+struct getSymbolAndType<Elf32_Rel> {
+
+  /// Returns the symbol of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Symbol information
+  static Elf32_Word getSym(Elf32_Xword info) {
+    return ELF32_R_SYM(static_cast<Elf32_Word>(info));
+  }
+
+  /// Returns the type of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Type information
+  static Elf32_Word getType(Elf32_Xword info) {
+    return ELF32_R_TYPE(static_cast<Elf32_Word>(info));
+  }
+};
+
+/// Specialized template for 32 Bit relocation with addends
+template<>
+struct getSymbolAndType<Elf32_Rela> {
+
+  /// Returns the symbol of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Symbol information
+  static Elf32_Word getSym(Elf32_Xword info) {
+    return ELF32_R_SYM(static_cast<Elf32_Word>(info));
+  }
+
+  /// Returns the type of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Type information
+  static Elf32_Word getType(Elf32_Xword info) {
+    return ELF32_R_TYPE(static_cast<Elf32_Word>(info));
+  }
+};
+
+/// Specialized template for 64 Bit relocation
+template<>
+struct getSymbolAndType<Elf64_Rel> {
+
+  /// Returns the symbol of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Symbol information
+  static Elf64_Word getSym(Elf64_Xword info) {
+    return static_cast<Elf64_Word>(ELF64_R_SYM(info));
+  }
+
+  /// Returns the type of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Type information
+  static Elf64_Word getType(Elf64_Xword info) {
+    return static_cast<Elf64_Word>(ELF64_R_TYPE(info));
+  }
+};
+
+/// Specialized template for 64 Bit relocation with addends
+template<>
+struct getSymbolAndType<Elf64_Rela> {
+
+  /// Returns the symbol of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Symbol information
+  static Elf64_Word getSym(Elf64_Xword info) {
+    return static_cast<Elf64_Word>(ELF64_R_SYM(info));
+  }
+
+  /// Returns the type of relocation info.
+  ///
+  /// \param info The relocation info
+  /// \return Type information
+  static Elf64_Word getType(Elf64_Xword info) {
+    return static_cast<Elf64_Word>(ELF64_R_TYPE(info));
+  }
+};
+
+
+/// Base class of all views on a single structure of an ELF image.
+///
+/// \tparam T Type of the viewed structure
+/// \tparam C Type of the endianess converter (\p EndianessConverter or
+///           \p StaticEndianessConverter)
+template<class T, class C>
+class RecordView {
+
+protected:
+  /// Pointer to the structure in the image
+  const T* Entry;
+  /// Converts the fields to the host's encoding
+  C Converter;
+
+public:
+  /// Type of the viewed structure
+  typedef T Entry_t;
+  /// Type of the endianess converter
+  typedef C Converter_t;
+
+  /// Constructor of \p RecordView.
+  ///
+  /// \param entry Pointer to the structure in the image
+  /// \param converter The converter to use
+  RecordView(const T* entry, const C& converter) : Entry(entry), Converter(converter) {}
+
+  /// Returns the viewed structure as it is stored in the image.
+  ///
+  /// \return Pointer to the raw structure
+  const T* getRaw() const {
+    return Entry;
+  }
+};
+
+
+/// View on the file header of an ELF image.
+template<class T, class C>
+class FileHeaderView final : public RecordView<T, C> {
+
+public:
+  using RecordView<T, C>::RecordView;
+
+  /// Returns the ELF file's type (\p e_type).
+  Elf64_Half getELFType() const { return this->Converter(this->Entry->e_type); }
+  /// Returns the machine architecture (\p e_machine).
+  Elf64_Half getMachine() const { return this->Converter(this->Entry->e_machine); }
+  /// Returns the file version (\p e_version).
+  Elf64_Word getVersion() const { return this->Converter(this->Entry->e_version); }
+  /// Returns the entry point (\p e_entry).
+  Elf64_Addr getEntryPoint() const { return this->Converter(this->Entry->e_entry); }
+  /// Returns the program header offset (\p e_phoff).
+  Elf64_Off getProgramHeaderOffset() const { return this->Converter(this->Entry->e_phoff); }
+  /// Returns the section header offset (\p e_shoff).
+  Elf64_Off getSectionHeaderOffset() const { return this->Converter(this->Entry->e_shoff); }
+  /// Returns the processor specific flags (\p e_flags).
+  Elf64_Word getFlags() const { return this->Converter(this->Entry->e_flags); }
+  /// Returns the size of the file header (\p e_ehsize).
+  Elf64_Half getHeaderSize() const { return this->Converter(this->Entry->e_ehsize); }
+  /// Returns the size of a program header (\p e_phentsize).
+  Elf64_Half getProgramHeaderSize() const { return this->Converter(this->Entry->e_phentsize); }
+  /// Returns the number of program headers (\p e_phnum).
+  Elf64_Half getProgramHeaderNumber() const { return this->Converter(this->Entry->e_phnum); }
+  /// Returns the size of a section header (\p e_shentsize).
+  Elf64_Half getSectionHeaderSize() const { return this->Converter(this->Entry->e_shentsize); }
+  /// Returns the number of section headers (\p e_shnum).
+  Elf64_Half getSectionHeaderNumber() const { return this->Converter(this->Entry->e_shnum); }
+  /// Returns the index of the section name string table (\p e_shstrndx).
+  Elf64_Half getSectionHeaderStringTableIndex() const { return this->Converter(this->Entry->e_shstrndx); }
+};
+
+
+/// View on a section header of an ELF image.
+template<class T, class C>
+class SectionHeaderView final : public RecordView<T, C> {
+
+public:
+  using RecordView<T, C>::RecordView;
+
+  /// Returns the offset of the name in the section name table (\p sh_name).
+  Elf64_Word getNameStringOffset() const { return this->Converter(this->Entry->sh_name); }
+  /// Returns the section's type (\p sh_type).
+  Elf64_Word getType() const { return this->Converter(this->Entry->sh_type); }
+  /// Returns the section's flags (\p sh_flags).
+  Elf64_Xword getFlags() const { return this->Converter(this->Entry->sh_flags); }
+  /// Returns the section's address (\p sh_addr).
+  Elf64_Addr getAddress() const { return this->Converter(this->Entry->sh_addr); }
+  /// Returns the section's offset in the image (\p sh_offset).
+  Elf64_Off getOffset() const { return this->Converter(this->Entry->sh_offset); }
+  /// Returns the section's size (\p sh_size).
+  Elf64_Xword getSize() const { return this->Converter(this->Entry->sh_size); }
+  /// Returns the section's \p sh_link field.
+  Elf64_Word getLink() const { return this->Converter(this->Entry->sh_link); }
+  /// Returns the section's \p sh_info field.
+  Elf64_Word getInfo() const { return this->Converter(this->Entry->sh_info); }
+  /// Returns the section's address alignment (\p sh_addralign).
+  Elf64_Xword getAddressAlignment() const { return this->Converter(this->Entry->sh_addralign); }
+  /// Returns the size of an entry in the section (\p sh_entsize).
+  Elf64_Xword getEntrySize() const { return this->Converter(this->Entry->sh_entsize); }
+};
+
+
+/// View on a program header of an ELF image.
+template<class T, class C>
+class ProgramHeaderView final : public RecordView<T, C> {
+
+public:
+  using RecordView<T, C>::RecordView;
+
+  /// Returns the segment's type (\p p_type).
+  Elf64_Word getType() const { return this->Converter(this->Entry->p_type); }
+  /// Returns the segment's flags (\p p_flags).
+  Elf64_Word getFlags() const { return this->Converter(this->Entry->p_flags); }
+  /// Returns the segment's offset in the image (\p p_offset).
+  Elf64_Off getOffset() const { return this->Converter(this->Entry->p_offset); }
+  /// Returns the segment's virtual address (\p p_vaddr).
+  Elf64_Addr getVirtualAddress() const { return this->Converter(this->Entry->p_vaddr); }
+  /// Returns the segment's physical address (\p p_paddr).
+  Elf64_Addr getPhysicalAddress() const { return this->Converter(this->Entry->p_paddr); }
+  /// Returns the segment's size in the image (\p p_filesz).
+  Elf64_Xword getFileSize() const { return this->Converter(this->Entry->p_filesz); }
+  /// Returns the segment's size in memory (\p p_memsz).
+  Elf64_Xword getMemorySize() const { return this->Converter(this->Entry->p_memsz); }
+  /// Returns the segment's alignment (\p p_align).
+  Elf64_Xword getAddressAlignment() const { return this->Converter(this->Entry->p_align); }
+};
+
+
+/// View on a symbol of an ELF image.
+template<class T, class C>
+class SymbolView final : public RecordView<T, C> {
+
+public:
+  using RecordView<T, C>::RecordView;
+
+  /// Returns the offset of the name in the string table (\p st_name).
+  Elf64_Word getNameOffset() const { return this->Converter(this->Entry->st_name); }
+  /// Returns the symbol's value (\p st_value).
+  Elf64_Addr getValue() const { return this->Converter(this->Entry->st_value); }
+  /// Returns the symbol's size (\p st_size).
+  Elf64_Xword getSize() const { return this->Converter(this->Entry->st_size); }
+  /// Returns the symbol's \p st_info field.
+  unsigned char getInfo() const { return this->Entry->st_info; }
+  /// Returns the symbol's binding (is the same for 32 and 64 Bit).
+  unsigned char getBind() const { return ELF64_ST_BIND(this->Entry->st_info); }
+  /// Returns the symbol's type (is the same for 32 and 64 Bit).
+  unsigned char getType() const { return ELF64_ST_TYPE(this->Entry->st_info); }
+  /// Returns the symbol's \p st_other field.
+  unsigned char getOther() const { return this->Entry->st_other; }
+  /// Returns the symbol's section index (\p st_shndx).
+  Elf64_Half getSectionIndex() const { return this->Converter(this->Entry->st_shndx); }
+};
+
+
+/// View on a relocation entry with or without addend of an ELF image.
+template<class T, class C>
+class RelocationView final : public RecordView<T, C> {
+
+private:
+  // relocations without addend
+  static Elf64_Sxword getAddend(const Elf32_Rel*, const C&) { return 0; }
+  static Elf64_Sxword getAddend(const Elf64_Rel*, const C&) { return 0; }
+
+  // relocations with addend
+  static Elf64_Sxword getAddend(const Elf32_Rela* entry, const C& converter) {
+    return converter(entry->r_addend);
+  }
+  static Elf64_Sxword getAddend(const Elf64_Rela* entry, const C& converter) {
+    return converter(entry->r_addend);
+  }
+
+public:
+  using RecordView<T, C>::RecordView;
+
+  /// Returns the relocation's offset (\p r_offset).
+  Elf64_Addr getOffset() const { return this->Converter(this->Entry->r_offset); }
+  /// Returns the relocation's \p r_info field.
+  Elf64_Xword getInfo() const { return this->Converter(this->Entry->r_info); }
+  /// Returns the index of the relocation's symbol.
+  Elf64_Word getSymbolIndex() const { return getSymbolAndType<T>::getSym(getInfo()); }
+  /// Returns the relocation's type.
+  Elf64_Word getType() const { return getSymbolAndType<T>::getType(getInfo()); }
+  /// Returns the relocation's addend or 0 for relocations without addend.
+  Elf64_Sxword getAddend() const { return getAddend(this->Entry, this->Converter); }
+};
+
+
+/// View on an entry of the dynamic section of an ELF image.
+template<class T, class C>
+class DynamicEntryView final : public RecordView<T, C> {
+
+public:
+  using RecordView<T, C>::RecordView;
+
+  /// Returns the entry's tag (\p d_tag).
+  Elf64_Sxword getTag() const { return this->Converter(this->Entry->d_tag); }
+  /// Returns the entry's value or address (\p d_un).
+  Elf64_Xword getValue() const { return this->Converter(this->Entry->d_un.d_val); }
+};
+
+
+/// View on a table of structures of the same type, like the section headers
+/// or the symbols of a symbol section. Can be indexed and iterated, every
+/// access returns a view of type \p V on one entry.
+///
+/// \tparam V The type of view on a single entry
+template<class V>
+class TableView final {
+
+public:
+  /// Type of the entries' structure
+  typedef typename V::Entry_t Entry_t;
+  /// Type of the endianess converter
+  typedef typename V::Converter_t Converter_t;
+
+  /// Iterator over the entries of a \p TableView
+  class Iterator final {
+
+  private:
+    /// The iterated table
+    const TableView* Table;
+    /// The current index
+    Elf64_Xword Index;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef V value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const V* pointer;
+    typedef V reference;
+
+    /// Constructor of \p Iterator.
+    ///
+    /// \param table The iterated table
+    /// \param index The index of the current entry
+    Iterator(const TableView* table, Elf64_Xword index) : Table(table), Index(index) {}
+
+    /// Returns the view on the current entry.
+    V operator*() const { return (*Table)[Index]; }
+    /// Advances to the next entry.
+    Iterator& operator++() { ++Index; return *this; }
+    /// Advances to the next entry.
+    Iterator operator++(int) { Iterator Result(*this); ++Index; return Result; }
+    /// Returns \p true if both iterators point to the same entry.
+    bool operator==(const Iterator& other) const { return Index == other.Index; }
+    /// Returns \p true if the iterators point to different entries.
+    bool operator!=(const Iterator& other) const { return Index != other.Index; }
+  };
+
+private:
+  /// Pointer to the first entry
+  const char* Data;
+  /// Number of entries
+  Elf64_Xword Count;
+  /// Distance of two entries in bytes
+  Elf64_Xword EntrySize;
+  /// Converts the fields to the host's encoding
+  Converter_t Converter;
+
+public:
+  /// Constructor of \p TableView. Creates an empty table.
+  ///
+  /// \param converter The converter to use
+  explicit TableView(const Converter_t& converter = Converter_t()) :
+      Data(nullptr), Count(0), EntrySize(sizeof(Entry_t)), Converter(converter) {}
+
+  /// Constructor of \p TableView. Tables whose entries are smaller than the
+  /// structure \p Entry_t are treated as empty.
+  ///
+  /// \param data Pointer to the first entry
+  /// \param size Size of the table in bytes
+  /// \param entrySize Distance of two entries in bytes
+  /// \param converter The converter to use
+  TableView(const char* data, Elf64_Xword size, Elf64_Xword entrySize,
+            const Converter_t& converter = Converter_t()) :
+      Data(data), Count(0), EntrySize(entrySize), Converter(converter) {
+    if (Data && EntrySize >= sizeof(Entry_t)) {
+      Count = size / EntrySize;
+    }
+  }
+
+  /// Creates a table on the data of a section of an \p ELFFile. The caller
+  /// must choose the view matching the file's class and encoding.
+  ///
+  /// \tparam S Type of the section (any class derived from \p Section)
+  /// \param section The section to view
+  /// \param converter The converter to use
+  /// \return Table on the section's data or empty table if it has no data
+  template<class S>
+  static TableView fromSection(const S& section,
+                               const Converter_t& converter = Converter_t()) {
+    if (section.getType() == SHT_NULL || section.getType() == SHT_NOBITS) {
+      return TableView(converter);
+    }
+    return TableView(section.getDataPointer(), section.getSize(), section.getEntrySize(), converter);
+  }
+
+  /// Returns the number of entries.
+  Elf64_Xword size() const { return Count; }
+  /// Returns \p true if the table has no entries.
+  bool empty() const { return Count == 0; }
+
+  /// Returns a view on the entry at \p index. The index is not checked.
+  V operator[](Elf64_Xword index) const {
+    return V(reinterpret_cast<const Entry_t*>(Data + index * EntrySize), Converter);
+  }
+
+  /// Returns an iterator to the first entry.
+  Iterator begin() const { return Iterator(this, 0); }
+  /// Returns an iterator behind the last entry.
+  Iterator end() const { return Iterator(this, Count); }
+};
+
+
+/// View on an ELF image in memory with a class and encoding fixed at compile
+/// time. Use \p isValid to check that an image matches the view before
+/// accessing it. All tables returned are bounds checked against the image and
+/// are empty if they do not fit.
+///
+/// \tparam T The type of ELF header (\p Elf32_Ehdr or \p Elf64_Ehdr)
+/// \tparam LittleEndian Encoding of the image is little endian (\p true)
+template<class T, bool LittleEndian>
+class ELFView final {
+
+public:
+  /// Structure types of the view's ELF class
+  typedef ELFClassTypes<T> Types;
+  /// Type of the endianess converter
+  typedef StaticEndianessConverter<LittleEndian> Converter_t;
+
+  /// View on the file header
+  typedef FileHeaderView<typename Types::Ehdr_t, Converter_t> FileHeader_t;
+  /// View on a section header
+  typedef SectionHeaderView<typename Types::Shdr_t, Converter_t> SectionHeader_t;
+  /// View on a program header
+  typedef ProgramHeaderView<typename Types::Phdr_t, Converter_t> ProgramHeader_t;
+  /// View on a symbol
+  typedef SymbolView<typename Types::Sym_t, Converter_t> Symbol_t;
+  /// View on a relocation without addend
+  typedef RelocationView<typename Types::Rel_t, Converter_t> Rel_t;
+  /// View on a relocation with addend
+  typedef RelocationView<typename Types::Rela_t, Converter_t> Rela_t;
+  /// View on a dynamic entry
+  typedef DynamicEntryView<typename Types::Dyn_t, Converter_t> DynamicEntry_t;
+
+  /// Table of section headers
+  typedef TableView<SectionHeader_t> SectionTable_t;
+  /// Table of program headers
+  typedef TableView<ProgramHeader_t> SegmentTable_t;
+  /// Table of symbols
+  typedef TableView<Symbol_t> SymbolTable_t;
+  /// Table of relocations without addend
+  typedef TableView<Rel_t> RelTable_t;
+  /// Table of relocations with addend
+  typedef TableView<Rela_t> RelaTable_t;
+  /// Table of dynamic entries
+  typedef TableView<DynamicEntry_t> DynamicTable_t;
+
+private:
+  /// Pointer to the image
+  const char* Data;
+  /// Size of the image
+  Elf64_Xword Size;
+
+  /// Returns a table of \p count entries of \p entrySize bytes at \p offset or
+  /// an empty table if it does not fit into the image.
+  template<class V>
+  TableView<V> getTable(Elf64_Off offset, Elf64_Xword count, Elf64_Xword entrySize) const {
+    if (offset > Size || entrySize == 0 || count > (Size - offset) / entrySize) {
+      return TableView<V>();
+    }
+    return TableView<V>(Data + offset, count * entrySize, entrySize);
+  }
+
+  /// Returns a table on the data of \p section.
+  template<class V>
+  TableView<V> getTable(const SectionHeader_t& section) const {
+    if (section.getType() == SHT_NOBITS || section.getEntrySize() == 0) {
+      return TableView<V>();
+    }
+    return getTable<V>(section.getOffset(), section.getSize() / section.getEntrySize(),
+                       section.getEntrySize());
+  }
+
+public:
+  /// Constructor of \p ELFView.
+  ///
+  /// \param data Pointer to the image
+  /// \param size Size of the image in bytes
+  ELFView(const char* data, Elf64_Xword size) : Data(data), Size(size) {}
+
+  /// Checks if an image is an ELF image of the view's class and encoding.
+  ///
+  /// \param data Pointer to the image
+  /// \param size Size of the image in bytes
+  /// \return \p true if the image can be viewed
+  static bool matches(const char* data, Elf64_Xword size) {
+    return data && size >= sizeof(typename Types::Ehdr_t) &&
+        std::memcmp(data, ELFMAG, SELFMAG) == 0 &&
+        data[EI_CLASS] == (Types::is64Bit ? ELFCLASS64 : ELFCLASS32) &&
+        data[EI_DATA] == (LittleEndian ? ELFDATA2LSB : ELFDATA2MSB);
+  }
+
+  /// Checks if the image is an ELF image of the view's class and encoding.
+  ///
+  /// \return \p true if the image can be viewed
+  bool isValid() const {
+    return matches(Data, Size);
+  }
+
+  /// Returns the file header. The image must be valid.
+  FileHeader_t getHeader() const {
+    return FileHeader_t(reinterpret_cast<const typename Types::Ehdr_t*>(Data), Converter_t());
+  }
+
+  /// Returns the table of section headers.
+  SectionTable_t getSections() const {
+    return getTable<SectionHeader_t>(getHeader().getSectionHeaderOffset(),
+                                     getHeader().getSectionHeaderNumber(),
+                                     getHeader().getSectionHeaderSize());
+  }
+
+  /// Returns the table of program headers.
+  SegmentTable_t getSegments() const {
+    return getTable<ProgramHeader_t>(getHeader().getProgramHeaderOffset(),
+                                     getHeader().getProgramHeaderNumber(),
+                                     getHeader().getProgramHeaderSize());
+  }
+
+  /// Returns the data of a section.
+  ///
+  /// \param section The section
+  /// \return Pointer to the data or \p nullptr if the section has no data in
+  ///         the image
+  const char* getSectionData(const SectionHeader_t& section) const {
+    if (section.getType() == SHT_NOBITS || section.getOffset() > Size ||
+        section.getSize() > Size - section.getOffset()) {
+      return nullptr;
+    }
+    return Data + section.getOffset();
+  }
+
+  /// Returns a string of a string section.
+  ///
+  /// \param section The string section
+  /// \param offset Offset of the string in the section
+  /// \return Pointer to the null-terminated string or \p nullptr if the string
+  ///         is not terminated within the section
+  const char* getString(const SectionHeader_t& section, Elf64_Word offset) const {
+    const char* Strings = getSectionData(section);
+    if (!Strings || offset >= section.getSize()) {
+      return nullptr;
+    }
+    const void* End = std::memchr(Strings + offset, '\0', section.getSize() - offset);
+    return End ? Strings + offset : nullptr;
+  }
+
+  /// Returns the symbols of a symbol section.
+  SymbolTable_t getSymbols(const SectionHeader_t& section) const {
+    return getTable<Symbol_t>(section);
+  }
+
+  /// Returns the relocations of a relocation section without addends.
+  RelTable_t getRelocations(const SectionHeader_t& section) const {
+    return getTable<Rel_t>(section);
+  }
+
+  /// Returns the relocations of a relocation section with addends.
+  RelaTable_t getRelocationsWithAddend(const SectionHeader_t& section) const {
+    return getTable<Rela_t>(section);
+  }
+
+  /// Returns the entries of a dynamic section.
+  DynamicTable_t getDynamicEntries(const SectionHeader_t& section) const {
+    return getTable<DynamicEntry_t>(section);
+  }
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_ELFVIEW_H
@@ -24,14 +24,15 @@
 
 /**
  * \file        endianutil.h
- * \brief       This header file declares a class for converting between
+ * \brief       This header file declares classes for converting between
  *              little and big endian.
  * \author      Darth-Revan
  * \date        2017
  * \copyright   MIT License
  *
- * This header file declares a class for converting between little and big
- * endian.
+ * This header file declares classes for converting between little and big
+ * endian, either with an encoding detected at runtime or with one fixed at
+ * compile time.
  */
 
 #ifndef LIBELFPP_ENDIANUTIL_H
@@ -41,6 +42,53 @@
 
 namespace libelfpp {
 
+/// \p true if the host system uses Little Endian encoding. Known at compile
+/// time with GCC and Clang, other compilers are assumed to be Little Endian.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool HostIsLittleEndian = false;
+#else
+constexpr bool HostIsLittleEndian = true;
+#endif
+
+/// Reverses the byte order of a 16 bit value.
+///
+/// \param value The value to convert
+/// \return \p value with reversed byte order
+constexpr uint16_t swapBytes(uint16_t value) {
+  return static_cast<uint16_t>(((value & 0x00FF) << 8) | ((value & 0xFF00) >> 8));
+}
+
+/// Reverses the byte order of a 32 bit value.
+///
+/// \param value The value to convert
+/// \return \p value with reversed byte order
+constexpr uint32_t swapBytes(uint32_t value) {
+  return static_cast<uint32_t>(
+      ((value & 0x000000FF) << 24) |
+          ((value & 0x0000FF00) << 8) |
+          ((value & 0x00FF0000) >> 8) |
+          ((value & 0xFF000000) >> 24)
+  );
+}
+
+/// Reverses the byte order of a 64 bit value.
+///
+/// \param value The value to convert
+/// \return \p value with reversed byte order
+constexpr uint64_t swapBytes(uint64_t value) {
+  return static_cast<uint64_t>(
+      ((value & 0x00000000000000FFull) << 56) |
+          ((value & 0x000000000000FF00ull) << 40) |
+          ((value & 0x0000000000FF0000ull) << 24) |
+          ((value & 0x00000000FF000000ull) << 8) |
+          ((value & 0x000000FF00000000ull) >> 8) |
+          ((value & 0x0000FF0000000000ull) >> 24) |
+          ((value & 0x00FF000000000000ull) >> 40) |
+          ((value & 0xFF00000000000000ull) >> 56)
+  );
+}
+
 /// Class for convenient conversion between Big and Little Endian encoding
 class EndianessConverter final {
 
@@ -94,11 +142,7 @@ public:
   /// \param value The value to convert
   /// \return Converted value or \p value if no conversion needed
   uint16_t operator()(uint16_t value) const {
-    if (!NeedConv)
-      return value;
-    value = static_cast<uint16_t>(((value & 0x00FF) << 8) |
-        ((value & 0xFF00) >> 8));
-    return value;
+    return NeedConv ? swapBytes(value) : value;
   }
 
   /// Conversion function for int16_t.
@@ -126,15 +170,7 @@ public:
   /// \param value The value to convert
   /// \return Converted value or \p value if no conversion needed
   uint32_t operator()(uint32_t value) const  {
-    if (!NeedConv)
-      return value;
-    value = static_cast<uint32_t>(
-        ((value & 0x000000FF) << 24) |
-            ((value & 0x0000FF00) << 8) |
-            ((value & 0x00FF0000) >> 8) |
-            ((value & 0xFF000000) >> 24)
-    );
-    return value;
+    return NeedConv ? swapBytes(value) : value;
   }
 
   /// Conversion function for int64_t.
@@ -152,23 +188,93 @@ public:
   /// \param value The value to convert
   /// \return Converted value or \p value if no conversion needed
   uint64_t operator()(uint64_t value) const {
-    if (!NeedConv)
-      return value;
-    value = static_cast<uint64_t>(
-        ((value & 0x00000000000000FFull) << 56) |
-            ((value & 0x000000000000FF00ull) << 40) |
-            ((value & 0x0000000000FF0000ull) << 24) |
-            ((value & 0x00000000FF000000ull) << 8) |
-            ((value & 0x000000FF00000000ull) >> 8) |
-            ((value & 0x0000FF0000000000ull) >> 24) |
-            ((value & 0x00FF000000000000ull) >> 40) |
-            ((value & 0xFF00000000000000ull) >> 56)
-    );
+    return NeedConv ? swapBytes(value) : value;
+  }
+
+};
+
+
+/// Variant of \p EndianessConverter whose encoding is fixed at compile time.
+/// Converting values compiles to a plain load if the encoding matches the
+/// host's and to a byte swap otherwise, without any runtime check.
+///
+/// \tparam LittleEndian Encoding of the data is little endian (\p true)
+template<bool LittleEndian>
+class StaticEndianessConverter final {
+
+public:
+  /// \p true if conversion is needed
+  static constexpr bool NeedConv = (LittleEndian != HostIsLittleEndian);
+
+  /// Conversion function for int8_t.
+  ///
+  /// \param value The value to convert
+  /// \return \p value
+  constexpr int8_t operator()(int8_t value) const {
     return value;
   }
 
+  /// Conversion function for uint8_t.
+  ///
+  /// \param value The value to convert
+  /// \return \p value
+  constexpr uint8_t operator()(uint8_t value) const {
+    return value;
+  }
+
+  /// Conversion function for uint16_t.
+  ///
+  /// \param value The value to convert
+  /// \return Converted value or \p value if no conversion needed
+  constexpr uint16_t operator()(uint16_t value) const {
+    return NeedConv ? swapBytes(value) : value;
+  }
+
+  /// Conversion function for int16_t.
+  ///
+  /// \param value The value to convert
+  /// \return Converted value or \p value if no conversion needed
+  constexpr int16_t operator()(int16_t value) const {
+    return static_cast<int16_t>((*this)(static_cast<uint16_t>(value)));
+  }
+
+  /// Conversion function for uint32_t.
+  ///
+  /// \param value The value to convert
+  /// \return Converted value or \p value if no conversion needed
+  constexpr uint32_t operator()(uint32_t value) const {
+    return NeedConv ? swapBytes(value) : value;
+  }
+
+  /// Conversion function for int32_t.
+  ///
+  /// \param value The value to convert
+  /// \return Converted value or \p value if no conversion needed
+  constexpr int32_t operator()(int32_t value) const {
+    return static_cast<int32_t>((*this)(static_cast<uint32_t>(value)));
+  }
+
+  /// Conversion function for uint64_t.
+  ///
+  /// \param value The value to convert
+  /// \return Converted value or \p value if no conversion needed
+  constexpr uint64_t operator()(uint64_t value) const {
+    return NeedConv ? swapBytes(value) : value;
+  }
+
+  /// Conversion function for int64_t.
+  ///
+  /// \param value The value to convert
+  /// \return Converted value or \p value if no conversion needed
+  constexpr int64_t operator()(int64_t value) const {
+    return static_cast<int64_t>((*this)(static_cast<uint64_t>(value)));
+  }
+
 };
 
+template<bool LittleEndian>
+constexpr bool StaticEndianessConverter<LittleEndian>::NeedConv;
+
 } // end of namespace libelfpp
 
 #endif //LIBELFPP_ENDIANUTIL_H
@@ -0,0 +1,185 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        filecache.h
+ * \brief       Header file declaring a cache of parsed ELF files
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares a cache that shares parsed ELF files between all
+ * parts of a process that open the same file.
+ */
+
+#ifndef LIBELFPP_FILECACHE_H
+#define LIBELFPP_FILECACHE_H
+
+#include "libelfpp.h"
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace libelfpp {
+
+/// Identity of a file on disk. A file keeps its identity under all paths
+/// leading to it and gets a new one when it is modified.
+struct FileIdentity final {
+  /// Device of the file (\p st_dev)
+  unsigned long long Device;
+  /// Inode of the file (\p st_ino)
+  unsigned long long Inode;
+  /// Modification time in nanoseconds
+  long long ModificationTime;
+  /// Size of the file
+  Elf64_Xword Size;
+
+  /// Returns the identity of the file at \p path.
+  ///
+  /// \param path Path to the file
+  /// \return Identity of the file
+  /// \throws std::runtime_error If the file does not exist
+  static FileIdentity fromPath(const std::string& path);
+};
+
+/// Checks if two identities are those of the same file.
+inline bool operator==(const FileIdentity& lhs, const FileIdentity& rhs) {
+  return lhs.Device == rhs.Device && lhs.Inode == rhs.Inode &&
+      lhs.ModificationTime == rhs.ModificationTime && lhs.Size == rhs.Size;
+}
+
+/// Checks if two identities are those of different files.
+inline bool operator!=(const FileIdentity& lhs, const FileIdentity& rhs) {
+  return !(lhs == rhs);
+}
+
+/// Statistics of an \p ELFFileCache
+struct FileCacheStatistics {
+  /// Number of requests served from the cache
+  Elf64_Xword Hits;
+  /// Number of requests that loaded the file
+  Elf64_Xword Misses;
+  /// Number of files evicted to stay within the byte budget
+  Elf64_Xword Evictions;
+  /// Number of files in the cache
+  Elf64_Xword Entries;
+  /// Sum of the sizes of the files in the cache
+  Elf64_Xword Bytes;
+};
+
+/// Cache of parsed ELF files, identified by device, inode, modification time
+/// and size, so a file is parsed once no matter under which path it is
+/// opened, and again once it changes. The least recently used files are
+/// evicted when the sizes of the cached files exceed the byte budget. Files
+/// are handed out as shared pointers, so an evicted file stays valid as long
+/// as anyone holds it. All member functions are thread-safe.
+///
+/// Files are loaded with \p LoadMode::Map by default and cached files keep
+/// their mappings alive, for the global cache as long as the process. Cached
+/// files must therefore not be truncated or rewritten in place (see
+/// \p LoadMode::Map), otherwise the process may receive \p SIGBUS. A file
+/// replaced by renaming a new file over it gets a new identity and is loaded
+/// again.
+class ELFFileCache final {
+
+private:
+  /// Hashes a \p FileIdentity
+  struct FileIdentityHash final {
+    std::size_t operator()(const FileIdentity& key) const;
+  };
+
+  /// A cached file
+  struct Entry final {
+    /// Identity of the file
+    FileIdentity Key;
+    /// The parsed file
+    std::shared_ptr<const ELFFile> File;
+  };
+
+  /// Guards all other members
+  mutable std::mutex Lock;
+  /// Strategy the files are loaded with
+  const LoadMode Mode;
+  /// Maximum sum of the sizes of the cached files
+  Elf64_Xword ByteBudget;
+  /// Cached files, the most recently used first
+  std::list<Entry> Entries;
+  /// Cached files by identity
+  std::unordered_map<FileIdentity, std::list<Entry>::iterator, FileIdentityHash> ByKey;
+  /// The statistics
+  FileCacheStatistics Statistics;
+
+  /// Evicts the least recently used files until the cache fits the budget.
+  /// \p Lock must be held.
+  void evict();
+
+public:
+  /// Default byte budget of 256 MiB
+  static const Elf64_Xword DefaultByteBudget = Elf64_Xword(256) << 20;
+
+  /// Constructor of \p ELFFileCache.
+  ///
+  /// \param byteBudget Maximum sum of the sizes of the cached files
+  /// \param mode Strategy the files are loaded with
+  explicit ELFFileCache(Elf64_Xword byteBudget = DefaultByteBudget,
+                        LoadMode mode = LoadMode::Map);
+
+  ELFFileCache(const ELFFileCache&) = delete;
+  ELFFileCache& operator=(const ELFFileCache&) = delete;
+
+  /// Returns the cache shared by the whole process. It maps files with the
+  /// default byte budget.
+  ///
+  /// \return Reference to the process-wide cache
+  static ELFFileCache& getGlobal();
+
+  /// Returns the parsed file at \p path, loading it if the cache holds no
+  /// file with the same identity. Files larger than the byte budget are
+  /// loaded but not cached.
+  ///
+  /// \param path Path to the file
+  /// \return Pointer to the file
+  /// \throws std::runtime_error If the file can not be loaded
+  std::shared_ptr<const ELFFile> get(const std::string& path);
+
+  /// Returns the byte budget.
+  Elf64_Xword getByteBudget() const;
+
+  /// Sets the byte budget and evicts files until the cache fits it.
+  ///
+  /// \param byteBudget Maximum sum of the sizes of the cached files
+  void setByteBudget(Elf64_Xword byteBudget);
+
+  /// Removes all files from the cache. The statistics are kept.
+  void clear();
+
+  /// Returns the statistics.
+  FileCacheStatistics getStatistics() const;
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_FILECACHE_H
@@ -0,0 +1,136 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        layoutindex.h
+ * \brief       Header file declaring an index of the layout of sections and
+ *              segments in an ELF file
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares an index that maps segments to the sections they
+ * contain and back, and file offsets and virtual addresses to the sections
+ * and segments holding them.
+ */
+
+#ifndef LIBELFPP_LAYOUTINDEX_H
+#define LIBELFPP_LAYOUTINDEX_H
+
+#include "section.h"
+#include "segment.h"
+#include <memory>
+#include <vector>
+
+namespace libelfpp {
+
+/// Index of the layout of the sections and segments of an ELF file, built
+/// once from intervals sorted by address and file offset. A section belongs
+/// to a segment if its address range (for \p SHF_ALLOC sections) or its file
+/// range (for all other sections) lies within the segment. Lookups by address
+/// or offset take O(log n) and consider sections with a size and, for
+/// segments, the \p PT_LOAD segments, which do not overlap in valid files.
+/// Files without \p PT_LOAD segments, like relocatable objects, have no
+/// sections at any address.
+class FileLayoutIndex final {
+
+private:
+  /// Range of addresses or file offsets taken by a section or segment
+  struct Interval {
+    /// First address or offset
+    Elf64_Addr Begin;
+    /// Behind the last address or offset
+    Elf64_Addr End;
+    /// Index of the section or segment
+    Elf64_Half Index;
+  };
+
+  /// All sections by index
+  std::vector<std::shared_ptr<Section>> Sections;
+  /// All segments by index
+  std::vector<std::shared_ptr<Segment>> Segments;
+  /// Sections with a size by address
+  std::vector<Interval> SectionsByAddress;
+  /// Sections with data in the file by offset
+  std::vector<Interval> SectionsByOffset;
+  /// \p PT_LOAD segments by address
+  std::vector<Interval> LoadsByAddress;
+  /// \p PT_LOAD segments by offset
+  std::vector<Interval> LoadsByOffset;
+  /// The sections of every segment, by section index
+  std::vector<std::vector<std::shared_ptr<Section>>> SegmentSections;
+  /// The segments of every section, by segment index
+  std::vector<std::vector<std::shared_ptr<Segment>>> SectionSegments;
+
+  /// Returns the index of the interval containing \p value or -1.
+  static long find(const std::vector<Interval>& intervals, Elf64_Addr value);
+
+public:
+  /// Constructor of \p FileLayoutIndex.
+  ///
+  /// \param sections All sections of the file, by index
+  /// \param segments All segments of the file, by index
+  FileLayoutIndex(const std::vector<std::shared_ptr<Section>>& sections,
+                  const std::vector<std::shared_ptr<Segment>>& segments);
+
+  /// Returns the sections within a segment, sorted by index.
+  ///
+  /// \param segment Index of the segment
+  /// \return The sections, empty if the index is out of bounds
+  const std::vector<std::shared_ptr<Section>>& getSectionsOfSegment(Elf64_Half segment) const;
+
+  /// Returns the segments containing a section, sorted by index.
+  ///
+  /// \param section Index of the section
+  /// \return The segments, empty if the index is out of bounds
+  const std::vector<std::shared_ptr<Segment>>& getSegmentsOfSection(Elf64_Half section) const;
+
+  /// Returns the section taking up a virtual address.
+  ///
+  /// \param address The virtual address
+  /// \return Pointer to the section or \p nullptr
+  std::shared_ptr<Section> findSectionByAddress(Elf64_Addr address) const;
+
+  /// Returns the section whose data contain a file offset.
+  ///
+  /// \param offset The file offset
+  /// \return Pointer to the section or \p nullptr
+  std::shared_ptr<Section> findSectionByOffset(Elf64_Off offset) const;
+
+  /// Returns the \p PT_LOAD segment a virtual address is mapped by.
+  ///
+  /// \param address The virtual address
+  /// \return Pointer to the segment or \p nullptr
+  std::shared_ptr<Segment> findSegmentByAddress(Elf64_Addr address) const;
+
+  /// Returns the \p PT_LOAD segment whose file data contain a file offset.
+  ///
+  /// \param offset The file offset
+  /// \return Pointer to the segment or \p nullptr
+  std::shared_ptr<Segment> findSegmentByOffset(Elf64_Off offset) const;
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_LAYOUTINDEX_H
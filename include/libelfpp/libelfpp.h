@@ -39,6 +39,12 @@
 #include "fileheader.h"
 #include "segment.h"
 #include "section.h"
+#include "addressindex.h"
+#include "layoutindex.h"
+#include "nameindex.h"
+#include "symbolhash.h"
+#include "symbolversion.h"
+#include <cstddef>
 #include <ostream>
 #include <memory>
 
@@ -53,13 +59,60 @@ inline const std::string getVersionString() {
 }
 
 
+/// Holds the lazily built indexes of an ELF file (implementation detail)
+struct FileIndexes;
+
+/// Strategies for loading the contents of an ELF file
+enum class LoadMode {
+  /// Reads the data of all sections and segments into memory when the file is
+  /// opened
+  Read,
+  /// Maps the file read-only into memory. Section and segment data are views
+  /// into the mapping, so opening the file only reads the headers and the
+  /// data stays in the page cache. The file must not be truncated or
+  /// rewritten in place while the \p ELFFile or any of its sections or
+  /// segments is alive: accessing truncated data raises \p SIGBUS and
+  /// rewritten data changes under the reader. Replace files by renaming a
+  /// new file over them instead.
+  Map,
+  /// Reads only the headers when the file is opened. The data of a section
+  /// or segment is read the first time it is accessed, so the file stays open
+  /// as long as any of its sections or segments is alive.
+  Lazy
+};
+
+
+/// Statistics about the reads an \p ELFFile issued to its underlying file
+struct IOStatistics {
+  /// Number of read system calls
+  Elf64_Xword ReadCalls;
+  /// Number of bytes read
+  Elf64_Xword BytesRead;
+};
+
+
 /// Class representing an ELF file;
+///
+/// Thread safety: all const member functions of one instance, its copies and
+/// the sections, segments and indexes it returns may be called concurrently
+/// from any number of threads. Everything the library computes on first use
+/// (data of lazily loaded files, the symbol, name, hash and version indexes,
+/// decoded dynamic entries, resolved symbols and scanned strings) is built
+/// exactly once under \p std::call_once and not modified afterwards, so reads
+/// do not take any locks once it is built. Assigning or destroying an
+/// instance while another thread uses the same instance is not safe.
 class ELFFile final {
 
 private:
   /// Holds the name of the underlying file
   const std::string Filename;
 
+  /// Holds the image the file's bytes are read from
+  std::shared_ptr<ImageSource> Source;
+
+  /// Holds the strategy the file's contents are loaded with
+  LoadMode Mode;
+
   /// \p true if file is little endian
   bool IsLittleEndian;
 
@@ -93,45 +146,74 @@ private:
   /// Holds pointers to all note sections of this file
   std::vector<std::shared_ptr<NoteSection>> NoteSections;
 
-  /// Loads all segmetns from the file stream \p stream and stores them in the
+  /// Holds the indexes built on first use, shared between copies
+  std::shared_ptr<FileIndexes> Indexes;
+
+  /// Parses the headers of the file from the image \p Source and loads all
+  /// sections and segments according to \p Mode.
+  ///
+  /// \throws std::runtime_exception If the image is no valid ELF file
+  void loadFromSource();
+
+  /// Loads all segmetns from the image \p Source and stores them in the
   /// vector \p Segements.
   ///
-  /// \param stream A file input stream to read from
   /// \return Number of segments loaded
-  Elf64_Half loadSegmentsFromFile(std::ifstream& stream);
+  Elf64_Half loadSegmentsFromFile();
 
-  /// Loads all sections from the file stream \p stream and stores them in
-  /// the vector \p VecSections.
+  /// Loads all sections from the image \p Source and stores them in the
+  /// vector \p Sections.
   ///
-  /// \param stream A file input stream to read from
   /// \return Number of sections loaded
-  Elf64_Half loadSectionsFromFile(std::ifstream& stream);
+  Elf64_Half loadSectionsFromFile();
 
 public:
   /// Constructor of \p ELFFile. Creates a new instance of the class or throws
   /// an \p runtime_exception if something goes wrong.
   ///
   /// \param filename Path to the file to create an instance upon
+  /// \param mode Strategy for loading the file's contents
   /// \throws std::runtime_exception If something goes wrong
-  ELFFile(const std::string& filename);
+  ELFFile(const std::string& filename, const LoadMode mode = LoadMode::Read);
+
+  /// Constructor of \p ELFFile. Creates a new instance of the class upon an
+  /// ELF image in memory or throws an \p runtime_exception if something goes
+  /// wrong. The buffer is not copied, all data of sections and segments are
+  /// views into it. Therefore the buffer must stay alive as long as the
+  /// instance or any of its sections or segments. Pass a handle owning the
+  /// buffer as \p owner to have the library keep it alive.
+  ///
+  /// \param data Pointer to the first byte of the image
+  /// \param size Size of the image in bytes
+  /// \param owner Optional handle keeping the buffer alive
+  /// \param name Name of the instance (returned by \p getName)
+  /// \throws std::runtime_exception If something goes wrong
+  ELFFile(const void* data, const std::size_t size,
+          const std::shared_ptr<const void>& owner = nullptr,
+          const std::string& name = std::string());
 
   /// Copy constructor of \p ELFFile.
   ///
   /// \param other The instance to copy
   ELFFile(const ELFFile& other) : Filename(other.Filename),
+                                  Source(other.Source),
+                                  Mode(other.Mode),
                                   IsLittleEndian(other.IsLittleEndian),
                                   Is64Bit(other.Is64Bit),
                                   Converter(other.Converter),
                                   FileHeader(other.FileHeader),
                                   Segments(other.Segments),
+                                  Sections(other.Sections),
                                   StrSection(other.StrSection),
                                   DynamicSec(other.DynamicSec),
                                   SymbolSections(other.SymbolSections),
                                   RelocSections(other.RelocSections),
-                                  NoteSections(other.NoteSections) {}
+                                  NoteSections(other.NoteSections),
+                                  Indexes(other.Indexes) {}
 
   /// Destructor of \p ELFFile.
   ~ELFFile() {
+    Source.reset();
     Converter.reset();
     FileHeader.reset();
     Segments.clear();
@@ -141,6 +223,7 @@ public:
     SymbolSections.clear();
     RelocSections.clear();
     NoteSections.clear();
+    Indexes.reset();
   }
 
   /// Returns the name of the underlying file a string.
@@ -214,12 +297,116 @@ public:
     return NoteSections;
   }
 
+  /// Returns the first section with the given name, e.g. \p .gnu_debuglink.
+  /// Looked up through a hash table built when the file is opened.
+  ///
+  /// \param name Name of the section
+  /// \return Pointer to the section or \p nullptr if there is none
+  const std::shared_ptr<Section> getSectionByName(const StringView& name) const;
+
+  /// Returns all sections with the given name in the order of the section
+  /// header table. Relocatable objects may have several sections of the same
+  /// name, e.g. \p .text of different comdat groups.
+  ///
+  /// \param name Name of the sections
+  /// \return Reference to the sections, empty if there are none
+  const std::vector<std::shared_ptr<Section>>& getSectionsByName(const StringView& name) const;
+
+  /// Returns all sections of the given type in the order of the section
+  /// header table, e.g. all \p SHT_PROGBITS or \p SHT_GROUP sections.
+  ///
+  /// \param type Type of the sections (\p SHT_...)
+  /// \return Reference to the sections, empty if there are none
+  const std::vector<std::shared_ptr<Section>>& getSectionsByType(Elf64_Word type) const;
+
   /// Returns a vector of strings, where each string is the name of a library
   /// that the underlying ELF file needs (entries in the dynamic section with
-  /// type DT_NEEDED).
+  /// type DT_NEEDED). The names are resolved on the first call.
+  ///
+  /// \return Reference to the vector of needed libraries
+  const std::vector<std::string>& getNeededLibraries() const;
+
+  /// Returns the index of the layout of sections and segments, which maps
+  /// sections to the segments containing them and file offsets and virtual
+  /// addresses to sections and segments.
+  ///
+  /// \return Pointer to the layout index
+  const std::shared_ptr<const FileLayoutIndex> getLayoutIndex() const;
+
+  /// Translates a virtual address to the file offset of the byte loaded to
+  /// it, using the \p PT_LOAD segments.
+  ///
+  /// \param address The virtual address
+  /// \param offset Set to the file offset if the translation succeeds
+  /// \return \p false if the address is not loaded from the file, i.e. not
+  ///         mapped or in the zero-filled tail of a segment
+  bool addressToOffset(Elf64_Addr address, Elf64_Off& offset) const;
+
+  /// Translates a file offset to the virtual address its byte is loaded to,
+  /// using the \p PT_LOAD segments.
+  ///
+  /// \param offset The file offset
+  /// \param address Set to the virtual address if the translation succeeds
+  /// \return \p false if the byte at \p offset is not loaded
+  bool offsetToAddress(Elf64_Off offset, Elf64_Addr& address) const;
+
+  /// Returns the data loaded to a range of virtual addresses, e.g. to read
+  /// pointer tables like \p .init_array or the GOT. Ranges within the file
+  /// data of a \p PT_LOAD segment are returned without copying. For ranges
+  /// reaching into the zero-filled tail of a segment (\p .bss), only the
+  /// requested bytes are copied and zero-filled, and the copy is kept as
+  /// long as the file.
+  ///
+  /// \param address First virtual address of the range
+  /// \param size Size of the range in bytes
+  /// \return Pointer to the data or \p nullptr if the range is not
+  ///         completely within one \p PT_LOAD segment, its bytes cannot be
+  ///         read or the copy cannot be allocated
+  const char* getDataAtAddress(Elf64_Addr address, Elf64_Xword size) const;
+
+  /// Returns an index for looking up the function or object symbol that
+  /// contains an address. The index covers all symbol sections and is built
+  /// on the first call.
+  ///
+  /// \return Pointer to the address index
+  const std::shared_ptr<const SymbolAddressIndex> getAddressIndex() const;
+
+  /// Returns an index for looking up symbols by name or name prefix. The
+  /// index covers all symbol sections, so it also works for files without
+  /// hash tables like relocatable objects. Built on the first call.
+  ///
+  /// \return Pointer to the name index
+  const std::shared_ptr<const SymbolNameIndex> getNameIndex() const;
+
+  /// Returns the lookup of dynamic symbols through the file's GNU hash table
+  /// or, if it has none, its SysV hash table. Built on the first call.
+  ///
+  /// \return Pointer to the lookup or \p nullptr if the file has no hash table
+  const std::shared_ptr<const SymbolHashTable> getSymbolHashTable() const;
+
+  /// Looks up a defined dynamic symbol by name, e.g. to check if a shared
+  /// object exports a function. Uses the file's hash table, so only the
+  /// symbols in the bucket of the name are looked at.
+  ///
+  /// \param name Name of the symbol
+  /// \return The symbol, if found
+  const SymbolLookupResult findDynamicSymbol(const StringView& name) const;
+
+  /// Returns the symbol versions of the dynamic symbols, decoded from the
+  /// \p SHT_GNU_versym, \p SHT_GNU_verdef and \p SHT_GNU_verneed sections.
+  /// Iterating it yields the dynamic symbols with their versions, which are
+  /// written as \p name\@VERSION. Built on the first call.
+  ///
+  /// \return Pointer to the version table or \p nullptr if the file has no
+  ///         version symbol section
+  const std::shared_ptr<const SymbolVersionTable> getSymbolVersionTable() const;
+
+  /// Returns statistics about the reads issued to the underlying file so far,
+  /// including reads of lazily loaded data. Mapped files and images in memory
+  /// do not issue reads.
   ///
-  /// \return Vector of needed libraries
-  const std::vector<std::string> getNeededLibraries() const;
+  /// \return Read statistics
+  const IOStatistics getIOStatistics() const;
 
   /// Overrides the stream operator << for \p ELFFile.
   ///
@@ -248,18 +435,18 @@ public:
 
 
 // Overrides the stream operator <<
-std::ostream& operator<<(std::ostream &stream, const ELFFile &file) {
+inline std::ostream& operator<<(std::ostream &stream, const ELFFile &file) {
   stream << "ELFFile (" << file.Filename << ")\n";
   return stream;
 }
 
 // Operator ==
-bool operator==(const ELFFile &lhs, const ELFFile &rhs) {
+inline bool operator==(const ELFFile &lhs, const ELFFile &rhs) {
   return (lhs.Filename == rhs.Filename);
 }
 
 // Operator !=
-bool operator!=(const ELFFile &lhs, const ELFFile &rhs) {
+inline bool operator!=(const ELFFile &lhs, const ELFFile &rhs) {
   return !operator==(lhs, rhs);
 }
 
@@ -0,0 +1,133 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        nameindex.h
+ * \brief       Header file declaring an index for looking up symbols by name
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares an index that maps names to symbols. Unlike the
+ * hash tables of an ELF file, it covers all symbol sections, including the
+ * \p .symtab of static executables and relocatable objects.
+ */
+
+#ifndef LIBELFPP_NAMEINDEX_H
+#define LIBELFPP_NAMEINDEX_H
+
+#include "section.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace libelfpp {
+
+/// Index for looking up symbols by name. Holds all named symbols of the given
+/// symbol sections, grouped by name and with the groups sorted by name, so
+/// the symbols with a name and the symbols with a name prefix are consecutive.
+/// Exact lookups go through an open addressing hash table with linear probing
+/// whose slots only hold the hash of a name and its group, so a lookup mostly
+/// touches a single cache line before comparing one name. Lookups do not
+/// allocate memory.
+class SymbolNameIndex final {
+
+private:
+  /// Slot of the hash table
+  struct Slot {
+    /// Hash of the name
+    uint32_t Hash;
+    /// Index of the group of the name plus one, 0 for empty slots
+    uint32_t Group;
+  };
+
+  /// Keeps the symbol sections, and so the names of the symbols, alive
+  std::vector<std::shared_ptr<SymbolSection>> Sections;
+  /// All indexed symbols grouped by name
+  std::vector<IndexedSymbol> Entries;
+  /// Index of the first entry of every group, followed by the number of
+  /// entries
+  std::vector<uint32_t> GroupStarts;
+  /// The hash table, its size is a power of two
+  std::vector<Slot> Slots;
+  /// Size of \p Slots minus one
+  uint32_t Mask;
+
+  /// Returns the symbols of a group.
+  IndexedSymbolRange getGroup(uint32_t group) const {
+    return {Entries.data() + GroupStarts[group], Entries.data() + GroupStarts[group + 1]};
+  }
+
+  /// Returns the name of a group.
+  const StringView& getGroupName(uint32_t group) const {
+    return Entries[GroupStarts[group]].Symbol.name;
+  }
+
+public:
+  /// Constructor of \p SymbolNameIndex. Indexes all symbols with a name of
+  /// the given sections, including undefined and local symbols.
+  ///
+  /// \param sections The symbol sections to index
+  explicit SymbolNameIndex(const std::vector<std::shared_ptr<SymbolSection>>& sections);
+
+  /// Returns all indexed symbols. Symbols with the same name are consecutive
+  /// and in the order of the sections and their symbols, the names are
+  /// sorted.
+  ///
+  /// \return Reference to the indexed symbols
+  const std::vector<IndexedSymbol>& getEntries() const {
+    return Entries;
+  }
+
+  /// Returns the number of distinct names.
+  ///
+  /// \return Number of names
+  std::size_t getNameCount() const {
+    return GroupStarts.size() - 1;
+  }
+
+  /// Returns all symbols with a name, e.g. the same symbol in \p .symtab and
+  /// \p .dynsym, or local symbols of different translation units.
+  ///
+  /// \param name The name of the symbols
+  /// \return The symbols, empty if there is none
+  IndexedSymbolRange find(const StringView& name) const;
+
+  /// Returns all symbols whose name starts with \p prefix in O(log n), e.g.
+  /// all members of a namespace by its mangled prefix.
+  ///
+  /// \param prefix The prefix of the names
+  /// \return The symbols sorted by name, empty if there is none
+  IndexedSymbolRange findPrefix(const StringView& prefix) const;
+
+  /// Computes the hash of a name used by the index (32 bit FNV-1a).
+  ///
+  /// \param name The name to hash
+  /// \return The hash value
+  static uint32_t hashName(const StringView& name);
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_NAMEINDEX_H
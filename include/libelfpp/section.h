@@ -36,12 +36,18 @@
 #define LIBELFPP_SECTION_H
 
 #include "endianutil.h"
+#include "elfview.h"
+#include "stringview.h"
+#include <memory>
 #include <vector>
 #include <string>
 #include <elf.h>
 
 namespace libelfpp {
 
+/// Provides the raw bytes of an ELF file (implementation detail)
+class ImageSource;
+
 /// Class representing an ELF file section
 class Section {
 
@@ -54,10 +60,19 @@ public:
   virtual ~Section() {};
 
   /// Returns the data associated with this section as plain character array.
+  /// The data is exactly \p getSize() bytes and not null terminated, as it
+  /// may be a view into the file, so it must not be passed to functions like
+  /// \p strlen. Use \p getDataString for a terminated copy.
   ///
   /// \return The data associated with this section
   virtual const char* getData() const = 0;
 
+  /// Returns the data associated with this section, unlike \p getData
+  /// without substituting an empty string if it could not be read.
+  ///
+  /// \return The data or \p nullptr if the section has no data
+  virtual const char* getDataPointer() const = 0;
+
   /// Returns the data associated with this section as string.
   ///
   /// \return The data associated with this section as string
@@ -138,11 +153,11 @@ public:
   virtual Elf64_Word getNameStringOffset() const = 0;
 
 protected:
-  /// Loads a section from a input stream at a specific stream offset.
+  /// Loads a section from an image at a specific offset.
   ///
-  /// \param stream The input stream to load from
-  /// \param offset The offset at which to load the section
-  virtual void loadSection(std::ifstream& stream, std::streampos offset) = 0;
+  /// \param source The image to load from
+  /// \param offset The offset of the section header in the image
+  virtual void loadSection(const std::shared_ptr<ImageSource>& source, Elf64_Off offset) = 0;
 
   /// Sets the section's member \p Name. This will not touch the file itself.
   ///
@@ -172,6 +187,35 @@ public:
   /// \return String at index \p index or empty string if failed
   virtual const std::string getString(const Elf64_Word index) const = 0;
 
+  /// Returns a view on the string at index without copying it. The string
+  /// ends at the next null character or at the end of the section, whichever
+  /// comes first.
+  ///
+  /// \param index The index of the string
+  /// \return View on the string or empty view if \p index is out of bounds
+  virtual StringView getStringView(const Elf64_Word index) const = 0;
+
+  /// Returns a view on the complete data of the string section.
+  ///
+  /// \return View on the data or empty view if the section has no data
+  virtual StringView getStringTable() const = 0;
+
+  /// Scans the section once and records where its strings start, their
+  /// lengths and which of them are equal. Afterwards \p getStringView and
+  /// \p isSameString need no scan of the data for indexes at the start of a
+  /// string. Optional, only worth it for tables that are looked up often.
+  /// Further calls do nothing.
+  virtual void scanStrings() const = 0;
+
+  /// Checks if the strings at two indexes are equal. After
+  /// \p scanStrings() this compares two numbers if both indexes are at the
+  /// start of a string.
+  ///
+  /// \param lhs Index of the first string
+  /// \param rhs Index of the second string
+  /// \return \p true if the strings are equal
+  virtual bool isSameString(const Elf64_Word lhs, const Elf64_Word rhs) const = 0;
+
 }; // end of class StringSection
 
 
@@ -257,6 +301,27 @@ public:
   /// \return Vector of pointers to dynamic section entries
   virtual const std::vector<DynamicSectionEntry> getAllEntries() const = 0;
 
+  /// Returns all entries of the dynamic section without copying them. The
+  /// section is decoded once, on the first call of any entry accessor.
+  ///
+  /// \return Reference to the entries
+  virtual const std::vector<DynamicSectionEntry>& entries() const = 0;
+
+  /// Returns the first entry with tag \p tag in O(1), e.g. \p DT_SONAME or
+  /// \p DT_FLAGS. Entries behind the terminating \p DT_NULL entry are
+  /// ignored, like by the dynamic linker.
+  ///
+  /// \param tag The tag to look up (\p DT_...)
+  /// \return Pointer to the entry or \p nullptr if there is none
+  virtual const DynamicSectionEntry* findEntry(const Elf64_Xword tag) const = 0;
+
+  /// Returns the string section the string values of the entries refer to,
+  /// e.g. those of \p DT_NEEDED or \p DT_RUNPATH.
+  ///
+  /// \return Pointer to the string section or \p nullptr if the link is
+  ///         invalid
+  virtual const std::shared_ptr<StringSection> getStringSection() const = 0;
+
 }; // end of class DynamicSection
 
 
@@ -318,6 +383,212 @@ struct Symbol final {
   }
 };
 
+/// Light-weight value object describing a symbol of a symbol section. Unlike
+/// \p Symbol it does not own its name, which refers into the string table of
+/// the ELF file and is valid as long as the symbol section is.
+struct SymbolRef final {
+  /// The symbol's name
+  StringView name;
+  /// Value of the field \p st_value
+  Elf64_Addr value;
+  /// Size of the symbol
+  Elf64_Xword size;
+  /// Symbol binding
+  unsigned char bind;
+  /// The type of the symbol
+  unsigned char type;
+  /// Section index of the symbol (\p st_shndx)
+  Elf64_Half sectionIndex;
+  /// Value of the field \p st_other
+  unsigned char other;
+
+  /// Returns a copy of the symbol that owns its name.
+  ///
+  /// \return The symbol as \p Symbol
+  Symbol toSymbol() const {
+    Symbol Result;
+    Result.name = name.str();
+    Result.value = value;
+    Result.size = size;
+    Result.bind = bind;
+    Result.type = type;
+    Result.sectionIndex = sectionIndex;
+    Result.other = other;
+    return Result;
+  }
+};
+
+/// Range over the symbols of a symbol section that decodes the symbols while
+/// iterating and does not allocate any memory. Valid as long as the symbol
+/// section it was created from.
+class SymbolRange final {
+
+public:
+  /// Forward iterator over a \p SymbolRange
+  class Iterator final {
+
+  private:
+    /// The iterated range
+    const SymbolRange* Range;
+    /// The current index
+    Elf64_Xword Index;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef SymbolRef value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const SymbolRef* pointer;
+    typedef SymbolRef reference;
+
+    /// Constructor of \p Iterator.
+    ///
+    /// \param range The iterated range
+    /// \param index The index of the current symbol
+    Iterator(const SymbolRange* range, Elf64_Xword index) : Range(range), Index(index) {}
+
+    /// Returns the current symbol.
+    SymbolRef operator*() const { return (*Range)[Index]; }
+    /// Advances to the next symbol.
+    Iterator& operator++() { ++Index; return *this; }
+    /// Advances to the next symbol.
+    Iterator operator++(int) { Iterator Result(*this); ++Index; return Result; }
+    /// Returns \p true if both iterators point to the same symbol.
+    bool operator==(const Iterator& other) const { return Index == other.Index; }
+    /// Returns \p true if the iterators point to different symbols.
+    bool operator!=(const Iterator& other) const { return Index != other.Index; }
+  };
+
+private:
+  /// Symbols of 64 Bit ELF files
+  TableView<SymbolView<Elf64_Sym, EndianessConverter>> Symbols64;
+  /// Symbols of 32 Bit ELF files
+  TableView<SymbolView<Elf32_Sym, EndianessConverter>> Symbols32;
+  /// \p true if the symbols are 64 Bit symbols
+  bool Is64Bit;
+  /// The associated string table
+  StringView Strings;
+
+  /// Returns a string of the string table, which need not be null-terminated.
+  StringView getName(Elf64_Word offset) const {
+    if (offset >= Strings.size()) {
+      return StringView();
+    }
+    const char* Begin = Strings.data() + offset;
+    const void* End = std::memchr(Begin, '\0', Strings.size() - offset);
+    return StringView(Begin, End ? static_cast<const char*>(End) - Begin : Strings.size() - offset);
+  }
+
+  /// Decodes a symbol.
+  template<class V>
+  SymbolRef decode(const V& symbol) const {
+    SymbolRef Result;
+    Result.name = getName(symbol.getNameOffset());
+    Result.value = symbol.getValue();
+    Result.size = symbol.getSize();
+    Result.bind = symbol.getBind();
+    Result.type = symbol.getType();
+    Result.sectionIndex = symbol.getSectionIndex();
+    Result.other = symbol.getOther();
+    return Result;
+  }
+
+public:
+  /// Constructor of \p SymbolRange.
+  ///
+  /// \param data Pointer to the first symbol
+  /// \param size Size of the symbol table in bytes
+  /// \param entrySize Size of a symbol in bytes
+  /// \param is64Bit \p true if the symbols are 64 Bit symbols
+  /// \param converter Converter for the encoding of the symbols
+  /// \param strings The associated string table
+  SymbolRange(const char* data, Elf64_Xword size, Elf64_Xword entrySize,
+              bool is64Bit, const EndianessConverter& converter,
+              const StringView& strings) :
+      Symbols64(converter), Symbols32(converter), Is64Bit(is64Bit), Strings(strings) {
+    if (is64Bit) {
+      Symbols64 = TableView<SymbolView<Elf64_Sym, EndianessConverter>>(data, size, entrySize, converter);
+    } else {
+      Symbols32 = TableView<SymbolView<Elf32_Sym, EndianessConverter>>(data, size, entrySize, converter);
+    }
+  }
+
+  /// Returns the number of symbols.
+  Elf64_Xword size() const { return Is64Bit ? Symbols64.size() : Symbols32.size(); }
+  /// Returns \p true if there are no symbols.
+  bool empty() const { return size() == 0; }
+
+  /// Returns the symbol at \p index. The index is not checked.
+  SymbolRef operator[](Elf64_Xword index) const {
+    return Is64Bit ? decode(Symbols64[index]) : decode(Symbols32[index]);
+  }
+
+  /// Returns an iterator to the first symbol.
+  Iterator begin() const { return Iterator(this, 0); }
+  /// Returns an iterator behind the last symbol.
+  Iterator end() const { return Iterator(this, size()); }
+};
+
+/// Symbol held by a symbol index, together with its position in the file
+struct IndexedSymbol final {
+  /// The symbol
+  SymbolRef Symbol;
+  /// Section index of the symbol section the symbol is taken from
+  Elf64_Half SymbolSectionIndex;
+  /// Index of the symbol in its symbol section
+  Elf64_Xword SymbolIndex;
+
+  /// Checks if the symbol contains an address. Symbols without size only
+  /// contain their own address.
+  ///
+  /// \param address The address to check
+  /// \return \p true if the symbol contains \p address
+  bool contains(Elf64_Addr address) const {
+    return address >= Symbol.value &&
+        (address - Symbol.value < Symbol.size || address == Symbol.value);
+  }
+
+  /// Returns the address behind the symbol. Symbols without size end behind
+  /// their own address.
+  ///
+  /// \return The end address, saturated at the highest address
+  Elf64_Addr end() const {
+    const Elf64_Xword Size = Symbol.size ? Symbol.size : 1;
+    return Symbol.value > ~Elf64_Addr(0) - Size ? ~Elf64_Addr(0) : Symbol.value + Size;
+  }
+};
+
+/// Range of consecutive symbols of a symbol index
+class IndexedSymbolRange final {
+
+private:
+  /// The first symbol
+  const IndexedSymbol* Begin;
+  /// Behind the last symbol
+  const IndexedSymbol* End;
+
+public:
+  /// Constructor of \p IndexedSymbolRange. Creates an empty range.
+  IndexedSymbolRange() : Begin(nullptr), End(nullptr) {}
+
+  /// Constructor of \p IndexedSymbolRange.
+  ///
+  /// \param begin The first symbol
+  /// \param end Behind the last symbol
+  IndexedSymbolRange(const IndexedSymbol* begin, const IndexedSymbol* end) :
+      Begin(begin), End(end) {}
+
+  /// Returns the number of symbols.
+  std::size_t size() const { return static_cast<std::size_t>(End - Begin); }
+  /// Returns \p true if the range is empty.
+  bool empty() const { return Begin == End; }
+  /// Returns the symbol at \p index. The index is not checked.
+  const IndexedSymbol& operator[](std::size_t index) const { return Begin[index]; }
+  /// Returns an iterator to the first symbol.
+  const IndexedSymbol* begin() const { return Begin; }
+  /// Returns an iterator behind the last symbol.
+  const IndexedSymbol* end() const { return End; }
+};
+
 /// Class representing a symbol section
 class SymbolSection : virtual public Section {
 
@@ -342,6 +613,45 @@ public:
   /// \return Vector containing pointers to all symbols in this section
   virtual const std::vector<std::shared_ptr<Symbol>> getAllSymbols() const = 0;
 
+  /// Returns a range over all symbols in this section. Iterating it does not
+  /// allocate memory, the names of the symbols refer into the string table.
+  ///
+  /// \return Range over the symbols of this section
+  virtual SymbolRange symbols() const = 0;
+
+  /// Returns the string section holding the names of the symbols. Symbol
+  /// sections linked to the same string section share one instance.
+  ///
+  /// \return Pointer to the string section
+  virtual const std::shared_ptr<StringSection> getStringSection() const = 0;
+
+  /// Returns all symbols of this section decoded into a table indexed by
+  /// symbol index, e.g. for resolving the symbols of relocations. The table
+  /// is built on the first call and shared by all callers, so every symbol is
+  /// decoded once no matter how many relocations refer to it.
+  ///
+  /// \return Pointer to the decoded symbols
+  virtual const std::shared_ptr<const std::vector<SymbolRef>> getResolvedSymbols() const = 0;
+
+  /// Decodes consecutive symbols into a buffer without allocating memory.
+  ///
+  /// \param first Index of the first symbol to decode
+  /// \param count Maximum number of symbols to decode
+  /// \param symbols Buffer for at least \p count symbols
+  /// \return Number of decoded symbols, less than \p count if the section
+  ///         ends before
+  virtual Elf64_Xword decodeSymbols(Elf64_Xword first, Elf64_Xword count,
+                                    SymbolRef* symbols) const = 0;
+
+  /// Decodes all symbols into a contiguous array, splitting large tables into
+  /// chunks that are decoded on several threads. The result is the same as
+  /// iterating \p symbols(). Tables of less than a few thousand symbols per
+  /// thread are decoded on the calling thread.
+  ///
+  /// \param threads Maximum number of threads, 0 for one per hardware thread
+  /// \return The symbols in the order of the section
+  virtual const std::vector<SymbolRef> decodeAllSymbols(unsigned int threads) const = 0;
+
 }; // end of class SymbolSection
 
 
@@ -361,119 +671,269 @@ struct RelocationEntry {
   std::shared_ptr<Symbol> SymbolInstance;
 };
 
-/// Template for retrieving type and symbol of a relocation entry
-template<typename T> struct getSymbolAndType;
+/// Relocation decoded without its symbol, see
+/// \p RelocationSection::decodeRecords. Unlike \p RelocationEntry it does not
+/// own any memory, so relocations can be decoded into plain arrays.
+struct RelocationRecord {
+  /// The offset of the relocation
+  Elf64_Addr Offset;
+  /// Info field of the relocation
+  Elf64_Xword Info;
+  /// The addend of the relocation (0 in relocation sections without addends)
+  Elf64_Sxword Addend;
+  /// The symbol table index of the relocation's symbol
+  Elf64_Word SymbolIndex;
+  /// The type of the relocation
+  Elf64_Word Type;
+};
 
-/// Specialized template for 32 Bit relocation
-template<>
-struct getSymbolAndType<Elf32_Rel> {
+/// Class representing a relocation section
+class RelocationSection : virtual public Section {
+
+public:
+  /// Destructor of \p RelocationSection
+  virtual ~RelocationSection() {}
 
-  /// Returns the symbol of relocation info.
+  /// Returns the entry at index \p index from the relocation section or
+  /// \p nullptr if the operation failed or the index would be out-of-bounds.
   ///
-  /// \param info The relocation info
-  /// \return Symbol information
-  static Elf32_Word getSym(Elf32_Xword info) {
-    return ELF32_R_SYM(static_cast<Elf32_Word>(info));
-  }
+  /// \param index The index of the entry
+  /// \return Pointer to a entry in the relocation section of \p nullptr
+  virtual const std::shared_ptr<RelocationEntry> getEntry(const Elf64_Xword index) const = 0;
 
-  /// Returns the type of relocation info.
+  /// Returns the number of entries in the relocation section.
   ///
-  /// \param info The relocation info
-  /// \return Type information
-  static Elf32_Word getType(Elf32_Xword info) {
-    return ELF32_R_TYPE(static_cast<Elf32_Word>(info));
-  }
-};
+  /// \return Number of entries in the relocation section
+  virtual const Elf64_Xword getNumEntries() const = 0;
 
-/// Specialized template for 32 Bit relocation with addends
-template<>
-struct getSymbolAndType<Elf32_Rela> {
+  /// Returns a vector containing all entries in this relocation section.
+  /// Entries that refer to the same symbol share one \p Symbol instance.
+  ///
+  /// \return Vector of pointers to relocation section entries
+  virtual const std::vector<std::shared_ptr<RelocationEntry>> getAllEntries() const = 0;
 
-  /// Returns the symbol of relocation info.
+  /// Returns the symbol section the relocations refer to. This is the same
+  /// instance as in \p ELFFile::symbolSections() and is shared by all
+  /// relocation sections linked to it.
   ///
-  /// \param info The relocation info
-  /// \return Symbol information
-  static Elf32_Word getSym(Elf32_Xword info) {
-    return ELF32_R_SYM(static_cast<Elf32_Word>(info));
-  }
+  /// \return Pointer to the symbol section or \p nullptr for sections of
+  ///         packed relative relocations
+  virtual const std::shared_ptr<SymbolSection> getSymbolSection() const = 0;
 
-  /// Returns the type of relocation info.
+  /// Decodes consecutive relocations into a buffer. Decoding does not
+  /// allocate memory and does not resolve symbols, the symbol of a record is
+  /// found at its \p SymbolIndex in
+  /// \p getSymbolSection()->getResolvedSymbols().
   ///
-  /// \param info The relocation info
-  /// \return Type information
-  static Elf32_Word getType(Elf32_Xword info) {
-    return ELF32_R_TYPE(static_cast<Elf32_Word>(info));
-  }
-};
+  /// \param first Index of the first relocation to decode
+  /// \param count Maximum number of relocations to decode
+  /// \param records Buffer for at least \p count records
+  /// \return Number of decoded relocations, less than \p count if the section
+  ///         ends before
+  virtual Elf64_Xword decodeRecords(Elf64_Xword first, Elf64_Xword count,
+                                    RelocationRecord* records) const = 0;
 
-/// Specialized template for 64 Bit relocation
-template<>
-struct getSymbolAndType<Elf64_Rel> {
+  /// Decodes all relocations of this section into a contiguous array.
+  ///
+  /// \return The relocations in the order of the section
+  virtual const std::vector<RelocationRecord> getAllRecords() const = 0;
 
-  /// Returns the symbol of relocation info.
+  /// Decodes all relocations into a contiguous array, splitting large
+  /// sections into chunks that are decoded on several threads. The result is
+  /// the same as that of \p getAllRecords(). Sections of less than a few
+  /// thousand relocations per thread, and packed relative relocations, are
+  /// decoded on the calling thread.
   ///
-  /// \param info The relocation info
-  /// \return Symbol information
-  static Elf64_Word getSym(Elf64_Xword info) {
-    return static_cast<Elf64_Word>(ELF64_R_SYM(info));
+  /// \param threads Maximum number of threads, 0 for one per hardware thread
+  /// \return The relocations in the order of the section
+  virtual const std::vector<RelocationRecord> decodeAllRecords(unsigned int threads) const = 0;
+
+}; // end of class RelocationSection
+
+
+/// Range over the offsets of packed relative relocations (\p SHT_RELR). An
+/// even word of the section is the offset of a relocation, an odd word is a
+/// bitmap whose bits 1 to n - 1 mark relocations at the n - 1 words following
+/// the previous relocation or bitmap. The offsets are expanded while
+/// iterating, without allocating memory. Valid as long as the section it was
+/// created from.
+class RelrRange final {
+
+public:
+  /// Forward iterator over a \p RelrRange
+  class Iterator final {
+
+  private:
+    /// The iterated range
+    const RelrRange* Range;
+    /// Index of the next word to read
+    Elf64_Xword Next;
+    /// Offset bit 0 of the current bitmap refers to
+    Elf64_Addr BitmapBase;
+    /// Remaining bits of the current bitmap
+    Elf64_Xword Bits;
+    /// Offset of the word behind the last one covered so far
+    Elf64_Addr Base;
+    /// The current offset
+    Elf64_Addr Current;
+    /// \p true if the iterator is behind the last offset
+    bool AtEnd;
+
+    /// Advances to the next offset.
+    void advance() {
+      while (Bits == 0) {
+        if (Next >= Range->Words) {
+          AtEnd = true;
+          return;
+        }
+        Elf64_Xword Word = Range->getWord(Next++);
+        if ((Word & 1) == 0) {
+          Current = Word;
+          Base = Word + Range->EntrySize;
+          return;
+        }
+        BitmapBase = Base;
+        Bits = Word >> 1;
+        Base += (Range->EntrySize * 8 - 1) * Range->EntrySize;
+      }
+      Current = BitmapBase + RelrRange::lowestBit(Bits) * Range->EntrySize;
+      Bits &= Bits - 1;
+    }
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Elf64_Addr value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Elf64_Addr* pointer;
+    typedef Elf64_Addr reference;
+
+    /// Constructor of \p Iterator.
+    ///
+    /// \param range The iterated range
+    /// \param atEnd \p true to create an iterator behind the last offset
+    Iterator(const RelrRange* range, bool atEnd) :
+        Range(range), Next(0), BitmapBase(0), Bits(0), Base(0), Current(0), AtEnd(atEnd) {
+      if (!AtEnd)
+        advance();
+    }
+
+    /// Returns the current offset.
+    Elf64_Addr operator*() const { return Current; }
+    /// Advances to the next offset.
+    Iterator& operator++() { advance(); return *this; }
+    /// Advances to the next offset.
+    Iterator operator++(int) { Iterator Result(*this); advance(); return Result; }
+    /// Returns \p true if both iterators point to the same offset.
+    bool operator==(const Iterator& other) const {
+      return AtEnd == other.AtEnd && (AtEnd || (Next == other.Next && Bits == other.Bits));
+    }
+    /// Returns \p true if the iterators point to different offsets.
+    bool operator!=(const Iterator& other) const { return !(*this == other); }
+  };
+
+private:
+  /// Pointer to the first word
+  const char* Data;
+  /// Number of words
+  Elf64_Xword Words;
+  /// Size of a word in bytes, 4 or 8
+  Elf64_Xword EntrySize;
+  /// Converter for the encoding of the words
+  EndianessConverter Converter;
+
+  /// Returns the word at \p index in host encoding. The index is not checked.
+  Elf64_Xword getWord(Elf64_Xword index) const {
+    if (EntrySize == sizeof(uint64_t)) {
+      uint64_t Word;
+      std::memcpy(&Word, Data + index * sizeof(Word), sizeof(Word));
+      return Converter(Word);
+    }
+    uint32_t Word;
+    std::memcpy(&Word, Data + index * sizeof(Word), sizeof(Word));
+    return Converter(Word);
   }
 
-  /// Returns the type of relocation info.
-  ///
-  /// \param info The relocation info
-  /// \return Type information
-  static Elf64_Word getType(Elf64_Xword info) {
-    return static_cast<Elf64_Word>(ELF64_R_TYPE(info));
+  /// Returns the index of the lowest set bit of \p bits, which must not be 0.
+  static unsigned int lowestBit(Elf64_Xword bits) {
+    return static_cast<unsigned int>(__builtin_ctzll(bits));
+  }
+
+public:
+  /// Constructor of \p RelrRange.
+  ///
+  /// \param data Pointer to the first word or \p nullptr
+  /// \param size Size of the section in bytes
+  /// \param entrySize Size of a word in bytes, 4 for 32 Bit files and 8 for
+  ///        64 Bit files
+  /// \param converter Converter for the encoding of the words
+  RelrRange(const char* data, Elf64_Xword size, Elf64_Xword entrySize,
+            const EndianessConverter& converter) :
+      Data(data), Words(0), EntrySize(entrySize), Converter(converter) {
+    if (data && (entrySize == sizeof(uint32_t) || entrySize == sizeof(uint64_t)))
+      Words = size / entrySize;
   }
-};
 
-/// Specialized template for 64 Bit relocation with addends
-template<>
-struct getSymbolAndType<Elf64_Rela> {
+  /// Returns \p true if there are no offsets.
+  bool empty() const { return Words == 0; }
 
-  /// Returns the symbol of relocation info.
+  /// Counts the offsets in one pass over the words.
   ///
-  /// \param info The relocation info
-  /// \return Symbol information
-  static Elf64_Word getSym(Elf64_Xword info) {
-    return static_cast<Elf64_Word>(ELF64_R_SYM(info));
+  /// \return Number of relocations
+  Elf64_Xword count() const {
+    Elf64_Xword Result = 0;
+    for (Elf64_Xword Index = 0; Index < Words; ++Index) {
+      Elf64_Xword Word = getWord(Index);
+      Result += (Word & 1) ? static_cast<Elf64_Xword>(__builtin_popcountll(Word >> 1)) : 1;
+    }
+    return Result;
   }
 
-  /// Returns the type of relocation info.
-  ///
-  /// \param info The relocation info
-  /// \return Type information
-  static Elf64_Word getType(Elf64_Xword info) {
-    return static_cast<Elf64_Word>(ELF64_R_TYPE(info));
+  /// Writes the offsets into a buffer, scanning every bitmap word for its
+  /// set bits instead of testing bit by bit.
+  ///
+  /// \param offsets Buffer for at least \p capacity offsets
+  /// \param capacity Maximum number of offsets to write
+  /// \return Number of written offsets, \p count() if \p capacity suffices
+  Elf64_Xword expand(Elf64_Addr* offsets, Elf64_Xword capacity) const {
+    Elf64_Xword Result = 0;
+    Elf64_Addr Base = 0;
+    for (Elf64_Xword Index = 0; Index < Words && Result < capacity; ++Index) {
+      Elf64_Xword Word = getWord(Index);
+      if ((Word & 1) == 0) {
+        offsets[Result++] = Word;
+        Base = Word + EntrySize;
+        continue;
+      }
+      for (Elf64_Xword Bits = Word >> 1; Bits != 0 && Result < capacity; Bits &= Bits - 1) {
+        offsets[Result++] = Base + lowestBit(Bits) * EntrySize;
+      }
+      Base += (EntrySize * 8 - 1) * EntrySize;
+    }
+    return Result;
   }
-};
 
+  /// Returns an iterator to the first offset.
+  Iterator begin() const { return Iterator(this, false); }
+  /// Returns an iterator behind the last offset.
+  Iterator end() const { return Iterator(this, true); }
+};
 
-/// Class representing a relocation section
-class RelocationSection : virtual public Section {
+/// Class representing a section of packed relative relocations
+/// (\p SHT_RELR). Its entries are relative relocations of the file's
+/// machine without symbol and with the addend stored at the relocated place.
+class RelrSection : virtual public RelocationSection {
 
 public:
-  /// Destructor of \p RelocationSection
-  virtual ~RelocationSection() {}
+  /// Destructor of \p RelrSection
+  virtual ~RelrSection() {}
 
-  /// Returns the entry at index \p index from the relocation section or
-  /// \p nullptr if the operation failed or the index would be out-of-bounds.
+  /// Returns a range over the offsets of the relocations that expands them
+  /// while iterating.
   ///
-  /// \param index The index of the entry
-  /// \return Pointer to a entry in the relocation section of \p nullptr
-  virtual const std::shared_ptr<RelocationEntry> getEntry(const Elf64_Xword index) const = 0;
+  /// \return Range over the offsets
+  virtual RelrRange offsets() const = 0;
 
-  /// Returns the number of entries in the relocation section.
-  ///
-  /// \return Number of entries in the relocation section
-  virtual const Elf64_Xword getNumEntries() const = 0;
-
-  /// Returns a vector containing all entries in this relocation section.
-  ///
-  /// \return Vector of pointers to relocation section entries
-  virtual const std::vector<std::shared_ptr<RelocationEntry>> getAllEntries() const = 0;
-
-}; // end of class RelocationSection
+}; // end of class RelrSection
 
 
 /// Struct representing a single entry in a note section
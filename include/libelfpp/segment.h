@@ -107,10 +107,19 @@ public:
   virtual Elf64_Off getOffset() const = 0;
 
   /// Returns the data associated with this segment as plain character array.
+  /// The data is exactly \p getFileSize() bytes and not null terminated, as
+  /// it may be a view into the file, so it must not be passed to functions
+  /// like \p strlen. Use \p getDataString for a terminated copy.
   ///
   /// \return The data associated with this segment
   virtual const char* getData() const = 0;
 
+  /// Returns the data associated with this segment, unlike \p getData
+  /// without substituting an empty string if it could not be read.
+  ///
+  /// \return The data or \p nullptr if the segment has no data
+  virtual const char* getDataPointer() const = 0;
+
   /// Returns the data associated with this segment as string.
   ///
   /// \return The data associated with this segment as string
@@ -128,23 +137,21 @@ public:
   virtual const std::vector<std::shared_ptr<Section>>& getAssociatedSections() const = 0;
 
 protected:
-  /// Loads a segment from a input stream at a specific stream offset.
+  /// Loads a segment from an image at a specific offset.
   ///
-  /// \param stream The input stream to load from
-  /// \param offset The offset at which to load the segment
-  virtual void loadSegment(std::ifstream& stream, std::streampos offset) = 0;
+  /// \param source The image to load from
+  /// \param offset The offset of the program header in the image
+  virtual void loadSegment(const std::shared_ptr<ImageSource>& source, Elf64_Off offset) = 0;
 
   /// Sets the segment's member \p Index. This will not touch the file itself.
   ///
   /// \param index The index for the segment
   virtual void setIndex(const Elf64_Half index) = 0;
 
-  /// Adds the section \p section to the list of associated sections.
+  /// Sets the list of associated sections.
   ///
-  /// \param section Pointer to the section to add
-  /// \return The number of sections associated with the segment after adding
-  ///         the new one.
-  virtual Elf64_Half addSection(const std::shared_ptr<Section>& section) = 0;
+  /// \param sections Pointers to the associated sections, without duplicates
+  virtual void setAssociatedSections(const std::vector<std::shared_ptr<Section>>& sections) = 0;
 
 }; // end of class Segment
 
@@ -0,0 +1,386 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file        snapshot.h
+ * \brief       Header file declaring on-disk snapshots of the metadata of ELF
+ *              files
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares a snapshot that stores the decoded metadata of an
+ * ELF file in a sidecar file, so that it can be reopened without parsing the
+ * ELF file again.
+ */
+
+#ifndef LIBELFPP_SNAPSHOT_H
+#define LIBELFPP_SNAPSHOT_H
+
+#include "libelfpp.h"
+#include "filecache.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libelfpp {
+
+/// Properties of the file header stored in a snapshot
+struct SnapshotFileInfo {
+  /// Entry point of the file
+  Elf64_Addr EntryPoint;
+  /// Version of the file
+  Elf64_Word Version;
+  /// Processor specific flags
+  Elf64_Word Flags;
+  /// Type of the file (\p ET_...)
+  Elf64_Half Type;
+  /// Machine of the file (\p EM_...)
+  Elf64_Half Machine;
+  /// 1 for 64 Bit files
+  unsigned char Is64Bit;
+  /// 1 for little endian files
+  unsigned char IsLittleEndian;
+  /// ABI of the file
+  unsigned char ABI;
+  /// Unused
+  unsigned char Reserved;
+};
+
+/// Section header stored in a snapshot
+struct SnapshotSection {
+  /// Flags of the section
+  Elf64_Xword Flags;
+  /// Address of the section
+  Elf64_Addr Address;
+  /// Offset of the section in the file
+  Elf64_Off Offset;
+  /// Size of the section
+  Elf64_Xword Size;
+  /// Address alignment of the section
+  Elf64_Xword AddressAlignment;
+  /// Size of the entries of the section
+  Elf64_Xword EntrySize;
+  /// Type of the section
+  Elf64_Word Type;
+  /// Link of the section
+  Elf64_Word Link;
+  /// Info of the section
+  Elf64_Word Info;
+  /// Offset of the name in the strings of the snapshot
+  Elf64_Word NameOffset;
+  /// Length of the name
+  Elf64_Word NameLength;
+  /// Unused
+  Elf64_Word Reserved;
+};
+
+/// Program header stored in a snapshot
+struct SnapshotSegment {
+  /// Offset of the segment in the file
+  Elf64_Off Offset;
+  /// Virtual address of the segment
+  Elf64_Addr VirtualAddress;
+  /// Physical address of the segment
+  Elf64_Addr PhysicalAddress;
+  /// Size of the segment in the file
+  Elf64_Xword FileSize;
+  /// Size of the segment in memory
+  Elf64_Xword MemorySize;
+  /// Address alignment of the segment
+  Elf64_Xword AddressAlignment;
+  /// Type of the segment
+  Elf64_Word Type;
+  /// Flags of the segment
+  Elf64_Word Flags;
+  /// Position of the first section index of the segment in the segment map
+  Elf64_Word FirstSection;
+  /// Number of sections of the segment
+  Elf64_Word SectionCount;
+};
+
+/// Symbol stored in a snapshot
+struct SnapshotSymbol {
+  /// Value of the symbol
+  Elf64_Addr Value;
+  /// Size of the symbol
+  Elf64_Xword Size;
+  /// Index of the symbol in its symbol section
+  Elf64_Xword SymbolIndex;
+  /// Offset of the name in the strings of the snapshot
+  Elf64_Word NameOffset;
+  /// Length of the name
+  Elf64_Word NameLength;
+  /// Index of the section the symbol is defined in
+  Elf64_Half SectionIndex;
+  /// Section index of the symbol section the symbol is taken from
+  Elf64_Half SymbolSectionIndex;
+  /// Binding of the symbol
+  unsigned char Bind;
+  /// Type of the symbol
+  unsigned char Type;
+  /// Other field of the symbol
+  unsigned char Other;
+  /// Unused
+  unsigned char Reserved;
+
+  /// Checks if the symbol contains an address. Symbols without size only
+  /// contain their own address.
+  ///
+  /// \param address The address to check
+  /// \return \p true if the symbol contains \p address
+  bool contains(Elf64_Addr address) const {
+    return address >= Value && (address - Value < Size || address == Value);
+  }
+};
+
+/// Dynamic section entry stored in a snapshot
+struct SnapshotDynamicEntry {
+  /// Tag of the entry
+  Elf64_Sxword Tag;
+  /// Value of the entry
+  Elf64_Xword Value;
+  /// Offset of the string the entry refers to in the strings of the
+  /// snapshot, for \p DT_NEEDED, \p DT_SONAME, \p DT_RPATH and \p DT_RUNPATH
+  Elf64_Word NameOffset;
+  /// Length of that string, 0 for other entries
+  Elf64_Word NameLength;
+};
+
+/// Slot of the name hash table stored in a snapshot
+struct SnapshotNameSlot {
+  /// Hash of the name (\p SymbolNameIndex::hashName)
+  Elf64_Word Hash;
+  /// Index of the symbol plus one, 0 for empty slots
+  Elf64_Word Symbol;
+};
+
+/// Array of records in a snapshot
+template <typename T>
+class SnapshotArray final {
+
+private:
+  /// The first record
+  const T* Data;
+  /// Number of records
+  std::size_t Count;
+
+public:
+  /// Constructor of \p SnapshotArray.
+  SnapshotArray(const T* data = nullptr, std::size_t count = 0) : Data(data), Count(count) {}
+
+  const T* begin() const {
+    return Data;
+  }
+
+  const T* end() const {
+    return Data + Count;
+  }
+
+  std::size_t size() const {
+    return Count;
+  }
+
+  bool empty() const {
+    return Count == 0;
+  }
+
+  const T& operator[](std::size_t index) const {
+    return Data[index];
+  }
+};
+
+/// Snapshot of the decoded metadata of an ELF file: the file header, the
+/// section and program headers, the mapping of segments to sections, the
+/// symbols of the address index with a hash table over their names, the
+/// dynamic section entries and the build-id. The snapshot is written to a
+/// sidecar file once and mapped into memory when it is opened, all accessors
+/// are views into the mapping, so nothing is decoded on reopen. The snapshot
+/// records the identity of the ELF file and is rejected if the file changed.
+/// Snapshots use the byte order of the host that wrote them and are rejected
+/// on hosts with another byte order. Opened snapshots are immutable and can
+/// be read from several threads.
+class MetadataSnapshot final {
+
+private:
+  /// The mapped snapshot file
+  std::shared_ptr<ImageSource> Image;
+  /// Identity of the ELF file the snapshot was taken from
+  FileIdentity Source;
+  /// The file header
+  SnapshotFileInfo Info;
+  /// The section headers
+  SnapshotArray<SnapshotSection> Sections;
+  /// The program headers
+  SnapshotArray<SnapshotSegment> Segments;
+  /// Section indexes of all segments, one run per segment
+  SnapshotArray<Elf64_Word> SegmentSections;
+  /// The symbols sorted by address
+  SnapshotArray<SnapshotSymbol> Symbols;
+  /// For every symbol the index of the closest preceding symbol reaching
+  /// beyond its start plus one, see \p SymbolAddressIndex::getEnclosing
+  SnapshotArray<Elf64_Word> EnclosingSymbols;
+  /// Hash table over the names of \p Symbols, its size is a power of two
+  SnapshotArray<SnapshotNameSlot> NameSlots;
+  /// The dynamic section entries up to \p DT_NULL
+  SnapshotArray<SnapshotDynamicEntry> DynamicEntries;
+  /// All names of the snapshot
+  StringView Strings;
+  /// The build-id
+  SnapshotArray<unsigned char> BuildId;
+
+  /// Constructor of \p MetadataSnapshot.
+  MetadataSnapshot() = default;
+
+public:
+  /// Version of the snapshot format. Snapshots of other versions are
+  /// rejected.
+  static const Elf64_Word FormatVersion = 2;
+
+  /// Writes a snapshot of \p file to \p path. The snapshot is written to a
+  /// temporary file of its own first and renamed, so readers never see a
+  /// partial snapshot, even if several threads or processes write the same
+  /// snapshot at once. The identity of the ELF file must be taken before it is
+  /// loaded, e.g. with \p FileIdentity::fromPath, so that a file replaced
+  /// while it was loaded is detected instead of stamping the old metadata
+  /// with the identity of the new file.
+  ///
+  /// \param file The ELF file, must have been loaded from a file
+  /// \param source Identity of the ELF file taken before it was loaded
+  /// \param path Path of the snapshot file
+  /// \return \p false if the ELF file changed since \p source was taken,
+  ///         nothing is written then
+  /// \throws std::runtime_error If the ELF file does not exist or the
+  ///         snapshot cannot be written
+  static bool write(const ELFFile& file, const FileIdentity& source, const std::string& path);
+
+  /// Opens the snapshot at \p path taken from the ELF file at \p sourcePath.
+  ///
+  /// \param path Path of the snapshot file
+  /// \param sourcePath Path of the ELF file
+  /// \return The snapshot or \p nullptr if the snapshot does not exist, is
+  ///         invalid or the ELF file changed since it was taken
+  static std::shared_ptr<const MetadataSnapshot> open(const std::string& path,
+                                                      const std::string& sourcePath);
+
+  /// Opens the snapshot at \p path, or loads the ELF file at \p sourcePath
+  /// and writes a new snapshot if there is no valid one.
+  ///
+  /// \param path Path of the snapshot file
+  /// \param sourcePath Path of the ELF file
+  /// \param mode Strategy to load the ELF file with
+  /// \return The snapshot or \p nullptr if the ELF file changed while the
+  ///         snapshot was written
+  /// \throws std::runtime_error If the ELF file cannot be loaded or the
+  ///         snapshot cannot be written
+  static std::shared_ptr<const MetadataSnapshot> openOrCreate(
+      const std::string& path, const std::string& sourcePath,
+      const LoadMode mode = LoadMode::Map);
+
+  /// Returns the identity of the ELF file the snapshot was taken from.
+  const FileIdentity& getSourceIdentity() const {
+    return Source;
+  }
+
+  /// Returns the properties of the file header.
+  const SnapshotFileInfo& getFileInfo() const {
+    return Info;
+  }
+
+  /// Returns the section headers in the order of the file.
+  const SnapshotArray<SnapshotSection>& getSections() const {
+    return Sections;
+  }
+
+  /// Returns the program headers in the order of the file.
+  const SnapshotArray<SnapshotSegment>& getSegments() const {
+    return Segments;
+  }
+
+  /// Returns the indexes of the sections of a segment.
+  ///
+  /// \param segment The program header of the segment
+  /// \return The section indexes
+  SnapshotArray<Elf64_Word> getSectionsOfSegment(const SnapshotSegment& segment) const;
+
+  /// Returns the symbols of the address index of the file, sorted like
+  /// \p SymbolAddressIndex::getEntries.
+  const SnapshotArray<SnapshotSymbol>& getSymbols() const {
+    return Symbols;
+  }
+
+  /// Returns the dynamic section entries up to \p DT_NULL.
+  const SnapshotArray<SnapshotDynamicEntry>& getDynamicEntries() const {
+    return DynamicEntries;
+  }
+
+  /// Returns the build-id of the file, empty if it has none.
+  const SnapshotArray<unsigned char>& getBuildId() const {
+    return BuildId;
+  }
+
+  /// Returns the name of a section, a symbol or the string of a dynamic
+  /// section entry.
+  ///
+  /// \param record A record of this snapshot
+  /// \return The name, empty if it lies outside the strings of the snapshot
+  template <typename T>
+  StringView getName(const T& record) const {
+    if (record.NameOffset > Strings.size() ||
+        record.NameLength > Strings.size() - record.NameOffset)
+      return StringView();
+    return StringView(Strings.data() + record.NameOffset, record.NameLength);
+  }
+
+  /// Returns the first section with a name.
+  ///
+  /// \param name The name of the section
+  /// \return Pointer to the section header or \p nullptr if there is none
+  const SnapshotSection* findSection(const StringView& name) const;
+
+  /// Returns the symbol that contains an address, with the same result as
+  /// \p SymbolAddressIndex::find.
+  ///
+  /// \param address The address to look up
+  /// \return Pointer to the symbol or \p nullptr if no symbol contains it
+  const SnapshotSymbol* findSymbol(Elf64_Addr address) const;
+
+  /// Returns all symbols with a name through the hash table of the snapshot.
+  ///
+  /// \param name The name of the symbols
+  /// \return Pointers to the symbols, empty if there is none
+  std::vector<const SnapshotSymbol*> findSymbols(const StringView& name) const;
+
+  /// Returns the first dynamic section entry with a tag.
+  ///
+  /// \param tag The tag of the entry
+  /// \return Pointer to the entry or \p nullptr if there is none
+  const SnapshotDynamicEntry* findDynamicEntry(Elf64_Sxword tag) const;
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_SNAPSHOT_H
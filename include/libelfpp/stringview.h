@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        stringview.h
+ * \brief       Header file declaring a non-owning reference to a string
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares a class that refers to a string stored somewhere
+ * else, like a name in the string table of an ELF file.
+ */
+
+#ifndef LIBELFPP_STRINGVIEW_H
+#define LIBELFPP_STRINGVIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+namespace libelfpp {
+
+/// Non-owning reference to a sequence of characters. Does not need to be
+/// null-terminated. The referenced characters must outlive the view, for
+/// strings of an ELF file this means the file or section they stem from.
+class StringView final {
+
+private:
+  /// Pointer to the first character
+  const char* Data;
+  /// Number of characters
+  std::size_t Size;
+
+public:
+  /// Constructor of \p StringView. Creates an empty view.
+  StringView() : Data(""), Size(0) {}
+
+  /// Constructor of \p StringView.
+  ///
+  /// \param data Pointer to the first character
+  /// \param size Number of characters
+  StringView(const char* data, std::size_t size) : Data(data), Size(size) {}
+
+  /// Constructor of \p StringView for null-terminated strings.
+  ///
+  /// \param str The string to refer to
+  StringView(const char* str) : Data(str), Size(std::strlen(str)) {}
+
+  /// Constructor of \p StringView.
+  ///
+  /// \param str The string to refer to
+  StringView(const std::string& str) : Data(str.data()), Size(str.size()) {}
+
+  /// Returns a pointer to the first character.
+  const char* data() const { return Data; }
+  /// Returns the number of characters.
+  std::size_t size() const { return Size; }
+  /// Returns the number of characters.
+  std::size_t length() const { return Size; }
+  /// Returns \p true if the view is empty.
+  bool empty() const { return Size == 0; }
+  /// Returns an iterator to the first character.
+  const char* begin() const { return Data; }
+  /// Returns an iterator behind the last character.
+  const char* end() const { return Data + Size; }
+  /// Returns the character at \p index. The index is not checked.
+  char operator[](std::size_t index) const { return Data[index]; }
+
+  /// Returns a copy of the referenced characters.
+  ///
+  /// \return The characters as string
+  std::string str() const {
+    return std::string(Data, Size);
+  }
+
+  /// Checks if the view starts with \p prefix.
+  ///
+  /// \param prefix The prefix to check for
+  /// \return \p true if \p prefix is a prefix of the view
+  bool startsWith(const StringView& prefix) const {
+    return prefix.Size <= Size && std::equal(prefix.begin(), prefix.end(), Data);
+  }
+
+  /// Compares two views lexicographically.
+  ///
+  /// \param other The view to compare with
+  /// \return Negative value, 0 or positive value if the view is less than,
+  ///         equal to or greater than \p other
+  int compare(const StringView& other) const {
+    int Result = std::memcmp(Data, other.Data, std::min(Size, other.Size));
+    if (Result != 0)
+      return Result;
+    return Size < other.Size ? -1 : (Size > other.Size ? 1 : 0);
+  }
+};
+
+/// Checks two views for equality.
+inline bool operator==(const StringView& lhs, const StringView& rhs) {
+  return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+/// Checks two views for inequality.
+inline bool operator!=(const StringView& lhs, const StringView& rhs) {
+  return !(lhs == rhs);
+}
+
+/// Checks if \p lhs is lexicographically less than \p rhs.
+inline bool operator<(const StringView& lhs, const StringView& rhs) {
+  return lhs.compare(rhs) < 0;
+}
+
+/// Writes the referenced characters to a stream.
+inline std::ostream& operator<<(std::ostream& stream, const StringView& view) {
+  return stream.write(view.data(), static_cast<std::streamsize>(view.size()));
+}
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_STRINGVIEW_H
@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        symbolhash.h
+ * \brief       Header file declaring a class for looking up dynamic symbols
+ *              by name through the hash tables of an ELF file
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares a class that looks up dynamic symbols by name
+ * with the GNU or SysV hash table of an ELF file, like the dynamic linker.
+ */
+
+#ifndef LIBELFPP_SYMBOLHASH_H
+#define LIBELFPP_SYMBOLHASH_H
+
+#include "section.h"
+#include <memory>
+
+namespace libelfpp {
+
+/// Result of a symbol lookup
+struct SymbolLookupResult final {
+  /// \p true if a symbol was found
+  bool Found;
+  /// Index of the symbol in its symbol section
+  Elf64_Xword Index;
+  /// The symbol, only valid if \p Found is \p true
+  SymbolRef Symbol;
+
+  /// Returns \p true if a symbol was found.
+  explicit operator bool() const {
+    return Found;
+  }
+};
+
+/// Looks up dynamic symbols by name with the hash table of an ELF file. The
+/// GNU hash table (\p SHT_GNU_HASH) with its bloom filter is preferred, the
+/// SysV hash table (\p SHT_HASH) is used if there is no GNU hash table. A
+/// lookup only touches the hash table entries and symbols in the bucket of
+/// the name and does not allocate memory.
+class SymbolHashTable final {
+
+private:
+  /// The hash section
+  std::shared_ptr<Section> Hash;
+  /// The data of the hash section
+  const char* Data;
+  /// Number of 32 bit words in the hash section
+  Elf64_Xword Words;
+  /// The dynamic symbol section the hash section refers to
+  std::shared_ptr<SymbolSection> Symbols;
+  /// The symbols of \p Symbols
+  SymbolRange Range;
+  /// Converts the words of the hash table to host encoding
+  EndianessConverter Converter;
+  /// \p true for 64 Bit files
+  bool Is64Bit;
+
+  /// Returns the 32 bit word at \p index of the hash table. The index must be
+  /// less than \p Words.
+  Elf64_Word getWord(Elf64_Xword index) const;
+
+  /// Checks if a symbol is a definition that can satisfy a lookup by name.
+  bool isMatch(const SymbolRef& symbol, const StringView& name) const;
+
+  /// Looks up a symbol with the GNU hash table.
+  SymbolLookupResult findGnu(const StringView& name) const;
+
+  /// Looks up a symbol with the SysV hash table.
+  SymbolLookupResult findSysV(const StringView& name) const;
+
+public:
+  /// Constructor of \p SymbolHashTable.
+  ///
+  /// \param hash The hash section (\p SHT_GNU_HASH or \p SHT_HASH)
+  /// \param data The data of \p hash or \p nullptr if it could not be loaded
+  /// \param symbols The symbol section the hash section refers to
+  /// \param converter Converter for the encoding of the file
+  /// \param is64Bit \p true for 64 Bit files
+  SymbolHashTable(const std::shared_ptr<Section>& hash, const char* data,
+                  const std::shared_ptr<SymbolSection>& symbols,
+                  const EndianessConverter& converter, bool is64Bit);
+
+  /// Returns the type of the hash table.
+  ///
+  /// \return \p SHT_GNU_HASH or \p SHT_HASH
+  Elf64_Word getType() const {
+    return Hash->getType();
+  }
+
+  /// Returns the symbol section the hash table refers to.
+  ///
+  /// \return Pointer to the dynamic symbol section
+  const std::shared_ptr<SymbolSection>& getSymbolSection() const {
+    return Symbols;
+  }
+
+  /// Looks up a defined global or weak symbol by name.
+  ///
+  /// \param name The name of the symbol
+  /// \return The symbol, if found
+  SymbolLookupResult find(const StringView& name) const;
+
+  /// Computes the GNU hash of a name.
+  ///
+  /// \param name The name to hash
+  /// \return The hash value
+  static Elf64_Word gnuHash(const StringView& name);
+
+  /// Computes the SysV hash of a name.
+  ///
+  /// \param name The name to hash
+  /// \return The hash value
+  static Elf64_Word sysvHash(const StringView& name);
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_SYMBOLHASH_H
@@ -0,0 +1,249 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        symbolversion.h
+ * \brief       Header file declaring a class for the symbol versions of the
+ *              dynamic symbols of an ELF file
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares a class that decodes the GNU symbol versioning
+ * sections (\p SHT_GNU_versym, \p SHT_GNU_verdef and \p SHT_GNU_verneed).
+ */
+
+#ifndef LIBELFPP_SYMBOLVERSION_H
+#define LIBELFPP_SYMBOLVERSION_H
+
+#include "section.h"
+#include <memory>
+#include <ostream>
+#include <vector>
+
+namespace libelfpp {
+
+/// A version defined (\p SHT_GNU_verdef) or required (\p SHT_GNU_verneed) by
+/// an ELF file, e.g. \p GLIBC_2.2.5
+struct SymbolVersion final {
+  /// Name of the version
+  StringView Name;
+  /// Name of the library the version is required from, empty for versions
+  /// defined by the file
+  StringView File;
+  /// Index of the version as used in the version symbol section
+  Elf64_Half Index;
+  /// Flags of the version (\p VER_FLG_BASE, \p VER_FLG_WEAK)
+  Elf64_Half Flags;
+  /// ELF hash of \p Name
+  Elf64_Word Hash;
+  /// \p true if the file defines the version, \p false if it requires it
+  bool IsDefinition;
+};
+
+/// A dynamic symbol together with its version
+struct VersionedSymbolRef final {
+  /// The symbol
+  SymbolRef Symbol;
+  /// The version of the symbol or \p nullptr for unversioned (local or
+  /// global) symbols
+  const SymbolVersion* Version;
+  /// \p true if the version is hidden, i.e. not the default version
+  bool IsHidden;
+
+  /// Returns \p true if the symbol is the default version of a symbol the
+  /// file defines, which is written as \p name\@\@VERSION.
+  bool isDefault() const {
+    return Version && Version->IsDefinition && !IsHidden;
+  }
+};
+
+/// Writes the name of a versioned symbol as \p name\@VERSION, or
+/// \p name\@\@VERSION for default versions, like \p readelf. Unversioned
+/// symbols are written by name only.
+inline std::ostream& operator<<(std::ostream& stream, const VersionedSymbolRef& symbol) {
+  stream << symbol.Symbol.name;
+  if (symbol.Version)
+    stream << (symbol.isDefault() ? "@@" : "@") << symbol.Version->Name;
+  return stream;
+}
+
+/// Symbol versions of the dynamic symbols of an ELF file. The version symbol
+/// section is decoded into an array that lines up with the dynamic symbol
+/// section, the defined and required versions into an array indexed by
+/// version index, so the version of a symbol is found in O(1). The names
+/// refer into the dynamic string table.
+class SymbolVersionTable final {
+
+public:
+  /// Forward iterator over the dynamic symbols and their versions
+  class Iterator final {
+
+  private:
+    /// The iterated table
+    const SymbolVersionTable* Table;
+    /// The current index
+    Elf64_Xword Index;
+
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef VersionedSymbolRef value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const VersionedSymbolRef* pointer;
+    typedef VersionedSymbolRef reference;
+
+    /// Constructor of \p Iterator.
+    ///
+    /// \param table The iterated table
+    /// \param index The index of the current symbol
+    Iterator(const SymbolVersionTable* table, Elf64_Xword index) : Table(table), Index(index) {}
+
+    /// Returns the current symbol.
+    VersionedSymbolRef operator*() const { return (*Table)[Index]; }
+    /// Advances to the next symbol.
+    Iterator& operator++() { ++Index; return *this; }
+    /// Advances to the next symbol.
+    Iterator operator++(int) { Iterator Result(*this); ++Index; return Result; }
+    /// Returns \p true if both iterators point to the same symbol.
+    bool operator==(const Iterator& other) const { return Index == other.Index; }
+    /// Returns \p true if the iterators point to different symbols.
+    bool operator!=(const Iterator& other) const { return Index != other.Index; }
+  };
+
+  /// The data of a versioning section
+  struct SectionData final {
+    /// The data or \p nullptr if there is no such section or its data could
+    /// not be loaded
+    const char* Data;
+    /// Size of the data in bytes
+    Elf64_Xword Size;
+    /// Number of entries (\p sh_info) of version definition and requirement
+    /// sections
+    Elf64_Word Count;
+  };
+
+private:
+  /// Keeps the dynamic symbols and their string section alive
+  std::shared_ptr<SymbolSection> Symbols;
+  /// The dynamic symbols
+  SymbolRange Range;
+  /// Raw version symbol entries by symbol index
+  std::vector<Elf64_Half> Versyms;
+  /// Defined and required versions
+  std::vector<SymbolVersion> Versions;
+  /// Position of the version in \p Versions plus one by version index, 0 for
+  /// unknown indexes
+  std::vector<Elf64_Word> ByIndex;
+
+  /// Decodes the version definitions.
+  void decodeDefinitions(const SectionData& verdef, const EndianessConverter& converter);
+
+  /// Decodes the version requirements.
+  void decodeRequirements(const SectionData& verneed, const EndianessConverter& converter);
+
+  /// Returns a string of the dynamic string table.
+  StringView getString(Elf64_Word offset) const;
+
+  /// Adds a version to \p Versions and \p ByIndex.
+  void addVersion(const SymbolVersion& version);
+
+public:
+  /// Constructor of \p SymbolVersionTable. Version names are looked up in
+  /// the string section of \p symbols. Definitions and requirements are
+  /// decoded up to the first invalid entry.
+  ///
+  /// \param symbols The dynamic symbol section
+  /// \param versym The data of the version symbol section
+  /// \param verdef The data of the version definition section
+  /// \param verneed The data of the version requirement section
+  /// \param converter Converter for the encoding of the file
+  SymbolVersionTable(const std::shared_ptr<SymbolSection>& symbols,
+                     const SectionData& versym, const SectionData& verdef,
+                     const SectionData& verneed, const EndianessConverter& converter);
+
+  /// Returns the number of dynamic symbols.
+  Elf64_Xword size() const {
+    return Range.size();
+  }
+
+  /// Returns the dynamic symbol section the table refers to.
+  const std::shared_ptr<SymbolSection>& getSymbolSection() const {
+    return Symbols;
+  }
+
+  /// Returns all versions the file defines or requires.
+  ///
+  /// \return Reference to the versions
+  const std::vector<SymbolVersion>& getVersions() const {
+    return Versions;
+  }
+
+  /// Returns the version index of a dynamic symbol without the hidden bit.
+  ///
+  /// \param symbolIndex Index of the symbol in the dynamic symbol section
+  /// \return The version index, \p VER_NDX_GLOBAL for symbols without entry
+  Elf64_Half getVersionIndex(Elf64_Xword symbolIndex) const {
+    return symbolIndex < Versyms.size() ? Elf64_Half(Versyms[symbolIndex] & 0x7fff)
+                                        : Elf64_Half(VER_NDX_GLOBAL);
+  }
+
+  /// Returns \p true if the version of a dynamic symbol is hidden.
+  ///
+  /// \param symbolIndex Index of the symbol in the dynamic symbol section
+  bool isHidden(Elf64_Xword symbolIndex) const {
+    return symbolIndex < Versyms.size() && (Versyms[symbolIndex] & 0x8000);
+  }
+
+  /// Returns a version by its version index.
+  ///
+  /// \param versionIndex The version index
+  /// \return Pointer to the version or \p nullptr for \p VER_NDX_LOCAL,
+  ///         \p VER_NDX_GLOBAL and unknown indexes
+  const SymbolVersion* findVersion(Elf64_Half versionIndex) const;
+
+  /// Returns the version of a dynamic symbol.
+  ///
+  /// \param symbolIndex Index of the symbol in the dynamic symbol section
+  /// \return Pointer to the version or \p nullptr for unversioned symbols
+  const SymbolVersion* getVersion(Elf64_Xword symbolIndex) const {
+    return findVersion(getVersionIndex(symbolIndex));
+  }
+
+  /// Returns a dynamic symbol with its version. The index is not checked.
+  ///
+  /// \param symbolIndex Index of the symbol in the dynamic symbol section
+  /// \return The symbol and its version
+  VersionedSymbolRef operator[](Elf64_Xword symbolIndex) const {
+    return {Range[symbolIndex], getVersion(symbolIndex), isHidden(symbolIndex)};
+  }
+
+  /// Returns an iterator to the first dynamic symbol.
+  Iterator begin() const { return Iterator(this, 0); }
+  /// Returns an iterator behind the last dynamic symbol.
+  Iterator end() const { return Iterator(this, size()); }
+};
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_SYMBOLVERSION_H
@@ -0,0 +1,200 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        addressindex.cpp
+ * \brief       Source file implementing the index for looking up symbols by
+ *              address
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p SymbolAddressIndex.
+ */
+
+#include "libelfpp/addressindex.h"
+#include <algorithm>
+
+namespace libelfpp {
+
+const unsigned int SymbolAddressIndex::DefaultTypes;
+
+/// Returns the rank of a symbol binding. Symbols with lower ranks are
+/// preferred if several symbols start at the same address.
+///
+/// \param bind The symbol binding
+/// \return The rank of \p bind
+static int getBindRank(unsigned char bind) {
+  switch (bind) {
+  case STB_GLOBAL:
+  case STB_GNU_UNIQUE:
+    return 0;
+  case STB_WEAK:
+    return 1;
+  default:
+    return 2;
+  }
+}
+
+// Indexes the symbols
+SymbolAddressIndex::SymbolAddressIndex(const std::vector<std::shared_ptr<SymbolSection>>& sections,
+                                       unsigned int types) :
+    Sections(sections), Entries(), Enclosing() {
+  for (const auto& Section : Sections) {
+    if (!Section)
+      continue;
+
+    Elf64_Xword Index = 0;
+    for (auto Symbol : Section->symbols()) {
+      if (Symbol.sectionIndex != SHN_UNDEF && Symbol.type < 32 &&
+          (types & (1u << Symbol.type))) {
+        Entries.push_back({Symbol, Section->getIndex(), Index});
+      }
+      ++Index;
+    }
+  }
+
+  std::sort(Entries.begin(), Entries.end(),
+            [](const IndexedSymbol& lhs, const IndexedSymbol& rhs) {
+    if (lhs.Symbol.value != rhs.Symbol.value)
+      return lhs.Symbol.value < rhs.Symbol.value;
+    int LhsRank = getBindRank(lhs.Symbol.bind);
+    int RhsRank = getBindRank(rhs.Symbol.bind);
+    if (LhsRank != RhsRank)
+      return LhsRank < RhsRank;
+    if (lhs.Symbol.name != rhs.Symbol.name)
+      return lhs.Symbol.name < rhs.Symbol.name;
+    return lhs.Symbol.size < rhs.Symbol.size;
+  });
+
+  // the same symbol may be defined in .symtab and .dynsym
+  Entries.erase(std::unique(Entries.begin(), Entries.end(),
+                            [](const IndexedSymbol& lhs, const IndexedSymbol& rhs) {
+    return lhs.Symbol.value == rhs.Symbol.value && lhs.Symbol.size == rhs.Symbol.size &&
+        lhs.Symbol.name == rhs.Symbol.name;
+  }), Entries.end());
+
+  // the starts are ascending, so a symbol ending at or before one start
+  // cannot reach beyond any later start and is dropped from the stack
+  std::vector<std::size_t> Open;
+  Enclosing.reserve(Entries.size());
+  for (std::size_t Index = 0; Index < Entries.size(); ++Index) {
+    while (!Open.empty() && Entries[Open.back()].end() <= Entries[Index].Symbol.value)
+      Open.pop_back();
+    Enclosing.push_back(Open.empty() ? 0 : Open.back() + 1);
+    Open.push_back(Index);
+  }
+}
+
+// Returns the best symbol at an address containing another address
+const IndexedSymbol* SymbolAddressIndex::findAt(
+    std::vector<IndexedSymbol>::const_iterator first, Elf64_Addr address) const {
+  Elf64_Addr Start = first->Symbol.value;
+  for (auto Iter = first; Iter != Entries.end() && Iter->Symbol.value == Start; ++Iter) {
+    if (Iter->contains(address))
+      return &*Iter;
+  }
+  return nullptr;
+}
+
+// Returns the best symbol containing an address, looking at enclosing
+// symbols if none at the address of first contains it
+const IndexedSymbol* SymbolAddressIndex::findFrom(
+    std::vector<IndexedSymbol>::const_iterator first, Elf64_Addr address) const {
+  if (const IndexedSymbol* Result = findAt(first, address))
+    return Result;
+
+  // entries between an entry and its link end before the entry's start, so
+  // they do not contain the address either
+  std::size_t Link = Enclosing[first - Entries.begin()];
+  while (Link != 0) {
+    const IndexedSymbol& Candidate = Entries[Link - 1];
+    if (Candidate.contains(address)) {
+      // prefer the best symbol starting at the same address
+      auto Group = std::lower_bound(Entries.begin(), Entries.begin() + Link,
+                                    Candidate.Symbol.value,
+                                    [](const IndexedSymbol& entry, Elf64_Addr value) {
+        return entry.Symbol.value < value;
+      });
+      return findAt(Group, address);
+    }
+    Link = Enclosing[Link - 1];
+  }
+  return nullptr;
+}
+
+// Looks up a single address
+const IndexedSymbol* SymbolAddressIndex::find(Elf64_Addr address) const {
+  auto Iter = std::upper_bound(Entries.begin(), Entries.end(), address,
+                               [](Elf64_Addr value, const IndexedSymbol& entry) {
+    return value < entry.Symbol.value;
+  });
+  if (Iter == Entries.begin())
+    return nullptr;
+
+  Elf64_Addr Start = std::prev(Iter)->Symbol.value;
+  auto First = std::lower_bound(Entries.begin(), Iter, Start,
+                                [](const IndexedSymbol& entry, Elf64_Addr value) {
+    return entry.Symbol.value < value;
+  });
+  return findFrom(First, address);
+}
+
+// Looks up sorted addresses in a single merge pass
+std::vector<const IndexedSymbol*> SymbolAddressIndex::findAll(
+    const std::vector<Elf64_Addr>& addresses) const {
+  std::vector<const IndexedSymbol*> Result;
+  Result.reserve(addresses.size());
+
+  // First is the first entry of the last address group starting at or
+  // before the current address, Next the first entry behind it
+  auto First = Entries.end();
+  auto Next = Entries.begin();
+  for (Elf64_Addr Address : addresses) {
+    while (Next != Entries.end() && Next->Symbol.value <= Address) {
+      First = Next;
+      while (Next != Entries.end() && Next->Symbol.value == First->Symbol.value)
+        ++Next;
+    }
+    Result.push_back(First != Entries.end() ? findFrom(First, Address) : nullptr);
+  }
+  return Result;
+}
+
+// Returns all symbols with the same address and size
+std::vector<const IndexedSymbol*> SymbolAddressIndex::getAliases(
+    const IndexedSymbol& entry) const {
+  std::vector<const IndexedSymbol*> Result;
+  auto Iter = std::lower_bound(Entries.begin(), Entries.end(), entry.Symbol.value,
+                               [](const IndexedSymbol& other, Elf64_Addr value) {
+    return other.Symbol.value < value;
+  });
+  for (; Iter != Entries.end() && Iter->Symbol.value == entry.Symbol.value; ++Iter) {
+    if (Iter->Symbol.size == entry.Symbol.size)
+      Result.push_back(&*Iter);
+  }
+  return Result;
+}
+
+} // end of namespace libelfpp
@@ -0,0 +1,240 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        corpus.cpp
+ * \brief       Source file implementing the loader for many ELF files
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p CorpusLoader.
+ */
+
+#include "libelfpp/corpus.h"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace libelfpp {
+
+/// Files assigned to one thread of a \p CorpusLoader
+struct WorkQueue final {
+  /// Guards \p Indexes
+  std::mutex Lock;
+  /// Indexes of the files not started yet
+  std::deque<std::size_t> Indexes;
+};
+
+/// Loads a single file and catches all errors.
+///
+/// \param index Position of the file in the list of paths
+/// \param path Path of the file
+/// \param mode Strategy to load the file with
+/// \return The result
+static CorpusResult loadFile(std::size_t index, const std::string& path, LoadMode mode) {
+  CorpusResult Result;
+  Result.Index = index;
+  Result.Path = path;
+  try {
+    Result.File = std::make_shared<ELFFile>(path, mode);
+  } catch (const std::exception& e) {
+    Result.Error = e.what();
+  } catch (...) {
+    Result.Error = "Unknown error!";
+  }
+  return Result;
+}
+
+/// Takes the next file of a thread's own queue or steals one from the end of
+/// the queue of another thread.
+///
+/// \param queues The queues of all threads
+/// \param self Index of the calling thread
+/// \param index Set to the index of the file
+/// \return \p false if all queues are empty
+static bool takeFile(std::vector<WorkQueue>& queues, std::size_t self, std::size_t& index) {
+  {
+    std::lock_guard<std::mutex> Lock(queues[self].Lock);
+    if (!queues[self].Indexes.empty()) {
+      index = queues[self].Indexes.front();
+      queues[self].Indexes.pop_front();
+      return true;
+    }
+  }
+  for (std::size_t Offset = 1; Offset < queues.size(); ++Offset) {
+    WorkQueue& Victim = queues[(self + Offset) % queues.size()];
+    std::lock_guard<std::mutex> Lock(Victim.Lock);
+    if (!Victim.Indexes.empty()) {
+      index = Victim.Indexes.back();
+      Victim.Indexes.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+// Loads the files on a pool of threads
+void CorpusLoader::load(const std::vector<std::string>& paths, const Callback& callback) const {
+  if (paths.empty())
+    return;
+
+  std::size_t ThreadCount = Options.Threads ? Options.Threads : std::thread::hardware_concurrency();
+  ThreadCount = std::max<std::size_t>(1, std::min(ThreadCount, paths.size()));
+  const std::size_t MaxInFlight = Options.MaxInFlight ? Options.MaxInFlight : 2 * ThreadCount;
+
+  // contiguous blocks keep files of the same directory on the same thread
+  std::vector<WorkQueue> Queues(ThreadCount);
+  for (std::size_t Index = 0; Index < paths.size(); ++Index) {
+    Queues[Index * ThreadCount / paths.size()].Indexes.push_back(Index);
+  }
+
+  std::mutex Lock;
+  std::condition_variable SlotFreed;
+  std::condition_variable ResultAdded;
+  std::deque<CorpusResult> Completed;
+  std::size_t InFlight = 0;
+  bool Stopped = false;
+
+  auto work = [&](std::size_t self) {
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> Guard(Lock);
+        SlotFreed.wait(Guard, [&]() { return Stopped || InFlight < MaxInFlight; });
+        if (Stopped)
+          return;
+        ++InFlight;
+      }
+
+      std::size_t Index;
+      if (!takeFile(Queues, self, Index)) {
+        std::lock_guard<std::mutex> Guard(Lock);
+        --InFlight;
+        SlotFreed.notify_one();
+        return;
+      }
+
+      CorpusResult Result = loadFile(Index, paths[Index], Options.Mode);
+      {
+        std::lock_guard<std::mutex> Guard(Lock);
+        Completed.push_back(std::move(Result));
+      }
+      ResultAdded.notify_one();
+    }
+  };
+
+  std::vector<std::thread> Threads;
+  auto stop = [&]() {
+    {
+      std::lock_guard<std::mutex> Guard(Lock);
+      Stopped = true;
+    }
+    SlotFreed.notify_all();
+    for (auto& Thread : Threads) {
+      Thread.join();
+    }
+  };
+
+  try {
+    for (std::size_t Thread = 0; Thread < ThreadCount; ++Thread) {
+      Threads.emplace_back(work, Thread);
+    }
+
+    for (std::size_t Delivered = 0; Delivered < paths.size(); ++Delivered) {
+      CorpusResult Result;
+      {
+        std::unique_lock<std::mutex> Guard(Lock);
+        ResultAdded.wait(Guard, [&]() { return !Completed.empty(); });
+        Result = std::move(Completed.front());
+        Completed.pop_front();
+      }
+      callback(Result);
+      Result = CorpusResult();
+
+      // the file is no longer in flight once the callback is done with it
+      {
+        std::lock_guard<std::mutex> Guard(Lock);
+        --InFlight;
+      }
+      SlotFreed.notify_one();
+    }
+  } catch (...) {
+    stop();
+    throw;
+  }
+  stop();
+}
+
+// Loads all files of a directory
+void CorpusLoader::loadDirectory(const std::string& directory, const Callback& callback) const {
+  load(findFiles(directory), callback);
+}
+
+// Collects the regular files of a directory
+std::vector<std::string> CorpusLoader::findFiles(const std::string& directory) {
+  DIR* Root = ::opendir(directory.c_str());
+  if (!Root) {
+    throw std::runtime_error("Could not open directory!");
+  }
+  ::closedir(Root);
+
+  std::vector<std::string> Result;
+  std::vector<std::string> Pending = {directory};
+  while (!Pending.empty()) {
+    std::string Current = Pending.back();
+    Pending.pop_back();
+    DIR* Dir = ::opendir(Current.c_str());
+    if (!Dir)
+      continue;
+
+    const std::string Prefix = Current.empty() || Current.back() == '/' ? Current : Current + "/";
+    while (const dirent* Entry = ::readdir(Dir)) {
+      const std::string Name = Entry->d_name;
+      if (Name == "." || Name == "..")
+        continue;
+
+      struct stat Status;
+      const std::string Path = Prefix + Name;
+      if (::lstat(Path.c_str(), &Status) != 0)
+        continue;
+      if (S_ISDIR(Status.st_mode)) {
+        Pending.push_back(Path);
+      } else if (S_ISREG(Status.st_mode)) {
+        Result.push_back(Path);
+      }
+    }
+    ::closedir(Dir);
+  }
+
+  std::sort(Result.begin(), Result.end());
+  return Result;
+}
+
+} // end of namespace libelfpp
@@ -0,0 +1,156 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        filecache.cpp
+ * \brief       Source file implementing the cache of parsed ELF files
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p ELFFileCache.
+ */
+
+#include "libelfpp/filecache.h"
+#include <functional>
+#include <stdexcept>
+#include <sys/stat.h>
+
+namespace libelfpp {
+
+const Elf64_Xword ELFFileCache::DefaultByteBudget;
+
+// Returns the identity of a file
+FileIdentity FileIdentity::fromPath(const std::string& path) {
+  struct stat Status;
+  if (::stat(path.c_str(), &Status) != 0) {
+    throw std::runtime_error("File does not exist!");
+  }
+  return {static_cast<unsigned long long>(Status.st_dev),
+          static_cast<unsigned long long>(Status.st_ino),
+          static_cast<long long>(Status.st_mtim.tv_sec) * 1000000000LL + Status.st_mtim.tv_nsec,
+          static_cast<Elf64_Xword>(Status.st_size)};
+}
+
+// Hashes the identity of a file
+std::size_t ELFFileCache::FileIdentityHash::operator()(const FileIdentity& key) const {
+  std::size_t Result = std::hash<unsigned long long>()(key.Inode);
+  for (std::size_t Part : {std::hash<unsigned long long>()(key.Device),
+                           std::hash<long long>()(key.ModificationTime),
+                           std::hash<Elf64_Xword>()(key.Size)}) {
+    Result ^= Part + 0x9e3779b97f4a7c15ull + (Result << 6) + (Result >> 2);
+  }
+  return Result;
+}
+
+// Creates the cache
+ELFFileCache::ELFFileCache(Elf64_Xword byteBudget, LoadMode mode) :
+    Lock(), Mode(mode), ByteBudget(byteBudget), Entries(), ByKey(),
+    Statistics({0, 0, 0, 0, 0}) {}
+
+// Returns the process-wide cache
+ELFFileCache& ELFFileCache::getGlobal() {
+  static ELFFileCache Global;
+  return Global;
+}
+
+// Returns a file, loading it on a miss
+std::shared_ptr<const ELFFile> ELFFileCache::get(const std::string& path) {
+  const FileIdentity Key = FileIdentity::fromPath(path);
+  {
+    std::lock_guard<std::mutex> Guard(Lock);
+    auto Iter = ByKey.find(Key);
+    if (Iter != ByKey.end()) {
+      ++Statistics.Hits;
+      Entries.splice(Entries.begin(), Entries, Iter->second);
+      return Iter->second->File;
+    }
+    ++Statistics.Misses;
+  }
+
+  // other files can be served while this one is loaded
+  std::shared_ptr<const ELFFile> File = std::make_shared<ELFFile>(path, Mode);
+
+  // a file changed while loading is not cached under its old identity
+  if (FileIdentity::fromPath(path) != Key)
+    return File;
+
+  std::lock_guard<std::mutex> Guard(Lock);
+  if (Key.Size > ByteBudget)
+    return File;
+  auto Iter = ByKey.find(Key);
+  if (Iter != ByKey.end()) {
+    // loaded by another thread in the meantime
+    Entries.splice(Entries.begin(), Entries, Iter->second);
+    return Iter->second->File;
+  }
+  Entries.push_front({Key, File});
+  ByKey.emplace(Key, Entries.begin());
+  ++Statistics.Entries;
+  Statistics.Bytes += Key.Size;
+  evict();
+  return File;
+}
+
+// Evicts the least recently used files
+void ELFFileCache::evict() {
+  while (Statistics.Bytes > ByteBudget && !Entries.empty()) {
+    const Entry& Last = Entries.back();
+    Statistics.Bytes -= Last.Key.Size;
+    --Statistics.Entries;
+    ++Statistics.Evictions;
+    ByKey.erase(Last.Key);
+    Entries.pop_back();
+  }
+}
+
+// Returns the byte budget
+Elf64_Xword ELFFileCache::getByteBudget() const {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return ByteBudget;
+}
+
+// Sets the byte budget
+void ELFFileCache::setByteBudget(Elf64_Xword byteBudget) {
+  std::lock_guard<std::mutex> Guard(Lock);
+  ByteBudget = byteBudget;
+  evict();
+}
+
+// Removes all files
+void ELFFileCache::clear() {
+  std::lock_guard<std::mutex> Guard(Lock);
+  Entries.clear();
+  ByKey.clear();
+  Statistics.Entries = 0;
+  Statistics.Bytes = 0;
+}
+
+// Returns the statistics
+FileCacheStatistics ELFFileCache::getStatistics() const {
+  std::lock_guard<std::mutex> Guard(Lock);
+  return Statistics;
+}
+
+} // end of namespace libelfpp
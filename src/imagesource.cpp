@@ -0,0 +1,283 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        imagesource.cpp
+ * \brief       Source file implementing the sources an ELF file's bytes are
+ *              read from
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the classes that provide the raw bytes of an
+ * ELF file to the library.
+ */
+
+#include "imagesource.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace libelfpp {
+
+// Copies bytes of the image into a buffer
+bool ImageSource::read(char* buffer, Elf64_Off offset, Elf64_Xword size) const {
+  if (!isValidRange(offset, size)) {
+    return false;
+  }
+  if (const char* Resident = getResidentData()) {
+    std::memcpy(buffer, Resident + offset, size);
+    return true;
+  }
+  return readBytes(buffer, offset, size);
+}
+
+// Returns a pointer to a range of the image
+std::shared_ptr<const char> ImageSource::getRange(Elf64_Off offset, Elf64_Xword size) const {
+  if (!isValidRange(offset, size)) {
+    return nullptr;
+  }
+  if (const char* Resident = getResidentData()) {
+    // alias the image, so the view keeps it alive
+    return std::shared_ptr<const char>(shared_from_this(), Resident + offset);
+  }
+
+  std::shared_ptr<char> Buffer;
+  try {
+    Buffer = std::shared_ptr<char>(new char[size], std::default_delete<char[]>());
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+  if (!readBytes(Buffer.get(), offset, size)) {
+    return nullptr;
+  }
+  return Buffer;
+}
+
+// Non-resident images must override this
+bool ImageSource::readBytes(char*, Elf64_Off, Elf64_Xword) const {
+  return false;
+}
+
+
+/// Clips \p ranges to an image of \p size bytes, sorts them and merges
+/// overlapping ranges and ranges that are at most \p gap bytes apart.
+///
+/// \param ranges The ranges to normalize
+/// \param size Size of the image
+/// \param gap Maximum distance of ranges to merge
+static void normalizeRanges(std::vector<ImageRange>& ranges, Elf64_Xword size,
+                            Elf64_Xword gap) {
+  std::vector<ImageRange> Result;
+  for (auto Range : ranges) {
+    if (Range.Offset >= size || Range.Size == 0)
+      continue;
+    Range.Size = std::min(Range.Size, size - Range.Offset);
+    Result.push_back(Range);
+  }
+  std::sort(Result.begin(), Result.end(), [](const ImageRange& lhs, const ImageRange& rhs) {
+    return lhs.Offset < rhs.Offset;
+  });
+
+  ranges.clear();
+  for (const auto& Range : Result) {
+    if (!ranges.empty() && Range.Offset <= ranges.back().Offset + ranges.back().Size + gap) {
+      Elf64_Off End = std::max(ranges.back().Offset + ranges.back().Size, Range.Offset + Range.Size);
+      ranges.back().Size = End - ranges.back().Offset;
+    } else {
+      ranges.push_back(Range);
+    }
+  }
+}
+
+
+// Opens the file
+FileImageSource::FileImageSource(const std::string& filename) :
+    Prefetched(), ReadCalls(0), BytesRead(0) {
+  Descriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (Descriptor < 0) {
+    throw std::runtime_error("File does not exist!");
+  }
+
+  struct stat Info;
+  if (::fstat(Descriptor, &Info) != 0) {
+    ::close(Descriptor);
+    throw std::runtime_error("Could not determine file size!");
+  }
+  Size = static_cast<Elf64_Xword>(Info.st_size);
+}
+
+// Closes the file
+FileImageSource::~FileImageSource() {
+  ::close(Descriptor);
+}
+
+// Reads bytes from the file or from prefetched ranges
+bool FileImageSource::readBytes(char* buffer, Elf64_Off offset, Elf64_Xword size) const {
+  for (const auto& Block : Prefetched) {
+    if (Block.first.Offset <= offset &&
+        offset + size <= Block.first.Offset + Block.first.Size) {
+      std::memcpy(buffer, Block.second.get() + (offset - Block.first.Offset), size);
+      return true;
+    }
+  }
+  return readFromFile(buffer, offset, size);
+}
+
+// Reads bytes from the file
+bool FileImageSource::readFromFile(char* buffer, Elf64_Off offset, Elf64_Xword size) const {
+  while (size > 0) {
+    ssize_t Count = ::pread(Descriptor, buffer, size, static_cast<off_t>(offset));
+    ++ReadCalls;
+    if (Count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (Count <= 0) {
+      return false;
+    }
+    BytesRead += static_cast<Elf64_Xword>(Count);
+    buffer += Count;
+    offset += static_cast<Elf64_Off>(Count);
+    size -= static_cast<Elf64_Xword>(Count);
+  }
+  return true;
+}
+
+// Reads ranges into memory
+bool FileImageSource::prefetch(std::vector<ImageRange> ranges) {
+  normalizeRanges(ranges, Size, MaxPrefetchGap);
+
+  for (const auto& Range : ranges) {
+    // ranges that have been prefetched before are not read again
+    bool Known = false;
+    for (const auto& Block : Prefetched) {
+      Known = Known || (Block.first.Offset <= Range.Offset &&
+          Range.Offset + Range.Size <= Block.first.Offset + Block.first.Size);
+    }
+    if (Known)
+      continue;
+
+    std::unique_ptr<char[]> Buffer;
+    try {
+      Buffer.reset(new char[Range.Size]);
+    } catch (const std::bad_alloc&) {
+      return false;
+    }
+    if (!readFromFile(Buffer.get(), Range.Offset, Range.Size)) {
+      return false;
+    }
+    Prefetched.emplace_back(Range, std::move(Buffer));
+  }
+  return true;
+}
+
+
+// Allocates the buffer
+BufferedImageSource::BufferedImageSource(const std::shared_ptr<ImageSource>& origin) :
+    Origin(origin), Buffer(nullptr, std::free), Filled() {
+  // calloc hands out untouched zero pages, so bytes that are never read do
+  // not occupy memory
+  Buffer.reset(static_cast<char*>(std::calloc(std::max<Elf64_Xword>(getSize(), 1), 1)));
+  if (!Buffer) {
+    throw std::runtime_error("Could not allocate memory for file!");
+  }
+}
+
+// Reads all ranges that have not been read before
+bool BufferedImageSource::prefetch(std::vector<ImageRange> ranges) {
+  normalizeRanges(ranges, getSize(), MaxPrefetchGap);
+
+  auto Covering = [this](Elf64_Off offset) {
+    auto Iter = std::upper_bound(Filled.begin(), Filled.end(), offset,
+        [](Elf64_Off value, const ImageRange& range) { return value < range.Offset; });
+    if (Iter == Filled.begin() || offset >= std::prev(Iter)->Offset + std::prev(Iter)->Size)
+      return Filled.end();
+    return std::prev(Iter);
+  };
+
+  for (const auto& Range : ranges) {
+    Elf64_Off Begin = Range.Offset;
+    Elf64_Off End = Range.Offset + Range.Size;
+
+    // skip bytes at both ends that have already been read, but read the rest
+    // at once even if it contains bytes that have been read before
+    for (auto Iter = Covering(Begin); Begin < End && Iter != Filled.end(); Iter = Covering(Begin))
+      Begin = Iter->Offset + Iter->Size;
+    for (auto Iter = Covering(End - 1); Begin < End && Iter != Filled.end(); Iter = Covering(End - 1))
+      End = Iter->Offset;
+
+    if (Begin < End && !Origin->read(Buffer.get() + Begin, Begin, End - Begin)) {
+      return false;
+    }
+  }
+
+  Filled.insert(Filled.end(), ranges.begin(), ranges.end());
+  normalizeRanges(Filled, getSize(), 0);
+  return true;
+}
+
+
+// Maps the file into memory
+MappedImageSource::MappedImageSource(const std::string& filename) :
+    Mapping(nullptr), Size(0) {
+  int Descriptor = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (Descriptor < 0) {
+    throw std::runtime_error("File does not exist!");
+  }
+
+  struct stat Info;
+  if (::fstat(Descriptor, &Info) != 0) {
+    ::close(Descriptor);
+    throw std::runtime_error("Could not determine file size!");
+  }
+  Size = static_cast<Elf64_Xword>(Info.st_size);
+
+  // mapping an empty file is not possible, but is also not needed
+  if (Size > 0) {
+    void* Addr = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+    if (Addr == MAP_FAILED) {
+      ::close(Descriptor);
+      throw std::runtime_error("Could not map file into memory!");
+    }
+    Mapping = static_cast<const char*>(Addr);
+  }
+  // the mapping stays valid after closing the descriptor
+  ::close(Descriptor);
+}
+
+// Unmaps the file
+MappedImageSource::~MappedImageSource() {
+  if (Mapping) {
+    ::munmap(const_cast<char*>(Mapping), Size);
+  }
+}
+
+} // end of namespace libelfpp
@@ -0,0 +1,381 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        imagesource.h
+ * \brief       Header file declaring the sources an ELF file's bytes are
+ *              read from
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This header file declares the classes that provide the raw bytes of an ELF
+ * file to the library. They are not exposed to library users.
+ */
+
+#ifndef LIBELFPP_IMAGESOURCE_H
+#define LIBELFPP_IMAGESOURCE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <elf.h>
+
+namespace libelfpp {
+
+/// A range of bytes in an image
+struct ImageRange {
+  /// Offset of the first byte
+  Elf64_Off Offset;
+  /// Number of bytes
+  Elf64_Xword Size;
+};
+
+/// Abstract base class for everything that provides the raw bytes of an ELF
+/// file (the "image").
+class ImageSource : public std::enable_shared_from_this<ImageSource> {
+
+public:
+  /// Destructor of \p ImageSource.
+  virtual ~ImageSource() {}
+
+  /// Returns the size of the image in bytes.
+  ///
+  /// \return Size of the image in bytes
+  virtual Elf64_Xword getSize() const = 0;
+
+  /// Returns a pointer to the first byte of the image if the whole image is
+  /// resident in memory, \p nullptr otherwise.
+  ///
+  /// \return Pointer to the image or \p nullptr
+  virtual const char* getResidentData() const = 0;
+
+  /// Copies \p size bytes at offset \p offset of the image into \p buffer.
+  ///
+  /// \param buffer The buffer to copy to
+  /// \param offset Offset of the first byte to copy
+  /// \param size Number of bytes to copy
+  /// \return \p true on success, \p false if the range is out of bounds or
+  ///         reading failed
+  bool read(char* buffer, Elf64_Off offset, Elf64_Xword size) const;
+
+  /// Returns a pointer to \p size bytes at offset \p offset of the image. The
+  /// returned pointer keeps the bytes alive. For resident images this is a
+  /// view into the image, otherwise the bytes are read into a new buffer.
+  ///
+  /// \param offset Offset of the first byte
+  /// \param size Number of bytes
+  /// \return Pointer to the bytes or \p nullptr on failure
+  std::shared_ptr<const char> getRange(Elf64_Off offset, Elf64_Xword size) const;
+
+  /// Returns \p true if the range of \p size bytes at \p offset lies within
+  /// the image.
+  ///
+  /// \param offset Offset of the first byte
+  /// \param size Number of bytes
+  /// \return \p true if the range is valid, \p false otherwise
+  bool isValidRange(Elf64_Off offset, Elf64_Xword size) const {
+    return offset <= getSize() && size <= getSize() - offset;
+  }
+
+  /// Announces that the ranges \p ranges will be accessed. Images that are
+  /// not resident read them now with as few reads as possible, all others do
+  /// nothing.
+  ///
+  /// \param ranges The ranges that will be accessed
+  /// \return \p false if reading failed, \p true otherwise
+  virtual bool prefetch(std::vector<ImageRange> ranges) {
+    (void) ranges;
+    return true;
+  }
+
+  /// Releases memory held for prefetched ranges that are not part of the
+  /// image itself. Must not be called concurrently with other functions.
+  virtual void releasePrefetched() {}
+
+  /// Returns the number of read system calls issued by this image.
+  ///
+  /// \return Number of read system calls
+  virtual Elf64_Xword getReadCalls() const {
+    return 0;
+  }
+
+  /// Returns the number of bytes read from the file by this image.
+  ///
+  /// \return Number of bytes read
+  virtual Elf64_Xword getBytesRead() const {
+    return 0;
+  }
+
+  /// Ranges closer to each other than this are read at once by \p prefetch.
+  static const Elf64_Xword MaxPrefetchGap = 32 * 1024;
+
+protected:
+  /// Reads \p size bytes at offset \p offset from a non-resident image.
+  ///
+  /// \param buffer The buffer to read into
+  /// \param offset Offset of the first byte to read
+  /// \param size Number of bytes to read
+  /// \return \p true on success, \p false otherwise
+  virtual bool readBytes(char* buffer, Elf64_Off offset, Elf64_Xword size) const;
+
+}; // end of class ImageSource
+
+
+/// Image that reads the bytes of a file on demand with \p pread.
+class FileImageSource final : public ImageSource {
+
+private:
+  /// The file descriptor of the opened file
+  int Descriptor;
+  /// The size of the file
+  Elf64_Xword Size;
+  /// Ranges read by \p prefetch, reads within them do not hit the file
+  std::vector<std::pair<ImageRange, std::unique_ptr<char[]>>> Prefetched;
+  /// Number of read system calls issued
+  mutable std::atomic<Elf64_Xword> ReadCalls;
+  /// Number of bytes read
+  mutable std::atomic<Elf64_Xword> BytesRead;
+
+public:
+  /// Constructor of \p FileImageSource. Opens the file \p filename for
+  /// reading.
+  ///
+  /// \param filename Path to the file
+  /// \throws std::runtime_error If the file cannot be opened
+  FileImageSource(const std::string& filename);
+
+  /// Destructor of \p FileImageSource. Closes the file.
+  ~FileImageSource();
+
+  FileImageSource(const FileImageSource&) = delete;
+  FileImageSource& operator=(const FileImageSource&) = delete;
+
+  Elf64_Xword getSize() const {
+    return Size;
+  }
+
+  const char* getResidentData() const {
+    return nullptr;
+  }
+
+  /// Reads \p ranges into memory, so that reads within them do not hit the
+  /// file. Ranges near each other are read at once. Not thread-safe, must
+  /// only be called while the file is loaded.
+  ///
+  /// \param ranges The ranges that will be accessed
+  /// \return \p false if reading failed, \p true otherwise
+  bool prefetch(std::vector<ImageRange> ranges);
+
+  void releasePrefetched() {
+    Prefetched.clear();
+  }
+
+  Elf64_Xword getReadCalls() const {
+    return ReadCalls;
+  }
+
+  Elf64_Xword getBytesRead() const {
+    return BytesRead;
+  }
+
+protected:
+  bool readBytes(char* buffer, Elf64_Off offset, Elf64_Xword size) const;
+
+private:
+  /// Reads bytes from the file with as few system calls as possible.
+  ///
+  /// \param buffer The buffer to read into
+  /// \param offset Offset of the first byte to read
+  /// \param size Number of bytes to read
+  /// \return \p true on success, \p false otherwise
+  bool readFromFile(char* buffer, Elf64_Off offset, Elf64_Xword size) const;
+
+}; // end of class FileImageSource
+
+
+/// Image held in a single buffer in memory that is filled from another image
+/// on request. All sections and segments are views into this buffer, so each
+/// byte of the file is held in memory at most once. Bytes that have not been
+/// prefetched read as zero.
+class BufferedImageSource final : public ImageSource {
+
+private:
+  /// The image the bytes are read from
+  const std::shared_ptr<ImageSource> Origin;
+  /// The buffer holding the bytes of the image
+  std::unique_ptr<char, void (*)(void*)> Buffer;
+  /// Sorted and disjoint ranges that have already been read
+  std::vector<ImageRange> Filled;
+
+public:
+  /// Constructor of \p BufferedImageSource. Does not read anything yet.
+  ///
+  /// \param origin The image to read from
+  /// \throws std::runtime_error If the buffer cannot be allocated
+  BufferedImageSource(const std::shared_ptr<ImageSource>& origin);
+
+  Elf64_Xword getSize() const {
+    return Origin->getSize();
+  }
+
+  const char* getResidentData() const {
+    return Buffer.get();
+  }
+
+  /// Reads all bytes of \p ranges that have not been read before. Ranges
+  /// near each other are read at once. Not thread-safe, must only be called
+  /// while the file is loaded.
+  ///
+  /// \param ranges The ranges that will be accessed
+  /// \return \p false if reading failed, \p true otherwise
+  bool prefetch(std::vector<ImageRange> ranges);
+
+  Elf64_Xword getReadCalls() const {
+    return Origin->getReadCalls();
+  }
+
+  Elf64_Xword getBytesRead() const {
+    return Origin->getBytesRead();
+  }
+
+}; // end of class BufferedImageSource
+
+
+/// Image backed by a read-only memory mapping of a file.
+class MappedImageSource final : public ImageSource {
+
+private:
+  /// Start of the mapping
+  const char* Mapping;
+  /// The size of the mapping
+  Elf64_Xword Size;
+
+public:
+  /// Constructor of \p MappedImageSource. Maps the file \p filename
+  /// read-only into memory.
+  ///
+  /// \param filename Path to the file
+  /// \throws std::runtime_error If the file cannot be opened or mapped
+  MappedImageSource(const std::string& filename);
+
+  /// Destructor of \p MappedImageSource. Unmaps the file.
+  ~MappedImageSource();
+
+  MappedImageSource(const MappedImageSource&) = delete;
+  MappedImageSource& operator=(const MappedImageSource&) = delete;
+
+  Elf64_Xword getSize() const {
+    return Size;
+  }
+
+  const char* getResidentData() const {
+    return Mapping;
+  }
+
+}; // end of class MappedImageSource
+
+
+/// Image backed by a buffer in memory that is owned by the caller.
+class MemoryImageSource final : public ImageSource {
+
+private:
+  /// Start of the buffer
+  const char* Buffer;
+  /// The size of the buffer
+  const Elf64_Xword Size;
+  /// Optional handle keeping the buffer alive
+  const std::shared_ptr<const void> Owner;
+
+public:
+  /// Constructor of \p MemoryImageSource. The buffer is not copied.
+  ///
+  /// \param data Pointer to the first byte of the buffer
+  /// \param size Size of the buffer in bytes
+  /// \param owner Optional handle that keeps the buffer alive
+  /// \throws std::runtime_error If \p data is \p nullptr
+  MemoryImageSource(const void* data, Elf64_Xword size,
+                    const std::shared_ptr<const void>& owner) :
+      Buffer(static_cast<const char*>(data)), Size(size), Owner(owner) {
+    if (!Buffer) {
+      throw std::runtime_error("Invalid buffer!");
+    }
+  }
+
+  Elf64_Xword getSize() const {
+    return Size;
+  }
+
+  const char* getResidentData() const {
+    return Buffer;
+  }
+
+}; // end of class MemoryImageSource
+
+
+/// A range of bytes of an image that is only fetched on first access. Access
+/// is thread-safe and the bytes are fetched at most once, also if several
+/// objects share the same instance.
+class LazyRange final {
+
+private:
+  /// The image to fetch the bytes from
+  const std::shared_ptr<ImageSource> Source;
+  /// Offset of the first byte in the image
+  const Elf64_Off Offset;
+  /// Number of bytes
+  const Elf64_Xword Size;
+  /// Guards the one-time fetch
+  mutable std::once_flag Fetched;
+  /// Holds the bytes after they have been fetched
+  mutable std::shared_ptr<const char> Data;
+
+public:
+  /// Constructor of \p LazyRange. Does not fetch any bytes.
+  ///
+  /// \param source The image to fetch from
+  /// \param offset Offset of the first byte
+  /// \param size Number of bytes
+  LazyRange(const std::shared_ptr<ImageSource>& source, Elf64_Off offset,
+            Elf64_Xword size) : Source(source), Offset(offset), Size(size) {}
+
+  LazyRange(const LazyRange&) = delete;
+  LazyRange& operator=(const LazyRange&) = delete;
+
+  /// Returns a pointer to the bytes, fetching them on the first call.
+  ///
+  /// \return Pointer to the bytes or \p nullptr if they cannot be fetched
+  const char* get() const {
+    std::call_once(Fetched, [this]() { Data = Source->getRange(Offset, Size); });
+    return Data.get();
+  }
+
+}; // end of class LazyRange
+
+} // end of namespace libelfpp
+
+#endif //LIBELFPP_IMAGESOURCE_H
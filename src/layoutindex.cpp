@@ -0,0 +1,174 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        layoutindex.cpp
+ * \brief       Source file implementing the index of the layout of sections
+ *              and segments
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p FileLayoutIndex.
+ */
+
+#include "libelfpp/layoutindex.h"
+#include <algorithm>
+
+namespace libelfpp {
+
+/// Sorts intervals by their start and index.
+///
+/// \param first The first interval
+/// \param second The second interval
+/// \return \p true if \p first is ordered before \p second
+template<class I>
+static bool isBefore(const I& first, const I& second) {
+  return first.Begin != second.Begin ? first.Begin < second.Begin : first.Index < second.Index;
+}
+
+// Builds the index
+FileLayoutIndex::FileLayoutIndex(const std::vector<std::shared_ptr<Section>>& sections,
+                                 const std::vector<std::shared_ptr<Segment>>& segments) :
+    Sections(sections), Segments(segments), SectionsByAddress(), SectionsByOffset(),
+    LoadsByAddress(), LoadsByOffset(), SegmentSections(segments.size()),
+    SectionSegments(sections.size()) {
+  // allocated sections belong to segments by address, all others by offset
+  std::vector<Interval> Allocated;
+  std::vector<Interval> Unallocated;
+  for (const auto& Sec : Sections) {
+    const Elf64_Addr Address = Sec->getAddress();
+    const Elf64_Off Offset = Sec->getOffset();
+    const Elf64_Xword Size = Sec->getSize();
+    const Elf64_Half Index = Sec->getIndex();
+
+    if (Sec->getFlags() & SHF_ALLOC) {
+      Allocated.push_back({Address, Address + Size, Index});
+      // thread local bss takes no address space of its own
+      bool IsTbss = Sec->getType() == SHT_NOBITS && (Sec->getFlags() & SHF_TLS);
+      if (Size != 0 && !IsTbss)
+        SectionsByAddress.push_back({Address, Address + Size, Index});
+    } else {
+      Unallocated.push_back({Offset, Offset + Size, Index});
+    }
+    if (Size != 0 && Sec->getType() != SHT_NULL && Sec->getType() != SHT_NOBITS)
+      SectionsByOffset.push_back({Offset, Offset + Size, Index});
+  }
+  std::sort(Allocated.begin(), Allocated.end(), isBefore<Interval>);
+  std::sort(Unallocated.begin(), Unallocated.end(), isBefore<Interval>);
+  std::sort(SectionsByAddress.begin(), SectionsByAddress.end(), isBefore<Interval>);
+  std::sort(SectionsByOffset.begin(), SectionsByOffset.end(), isBefore<Interval>);
+
+  // only sections starting within a segment can lie within it
+  auto collect = [](const std::vector<Interval>& intervals, Elf64_Addr begin, Elf64_Addr end,
+                    std::vector<Elf64_Half>& members) {
+    auto Iter = std::lower_bound(intervals.begin(), intervals.end(), begin,
+                                 [](const Interval& interval, Elf64_Addr value) {
+      return interval.Begin < value;
+    });
+    for (; Iter != intervals.end() && Iter->Begin <= end; ++Iter) {
+      if (Iter->End <= end)
+        members.push_back(Iter->Index);
+    }
+  };
+
+  for (const auto& Seg : Segments) {
+    const Elf64_Half Index = Seg->getIndex();
+    const Elf64_Addr Address = Seg->getVirtualAddress();
+    const Elf64_Off Offset = Seg->getOffset();
+
+    std::vector<Elf64_Half> Members;
+    collect(Allocated, Address, Address + Seg->getMemorySize(), Members);
+    collect(Unallocated, Offset, Offset + Seg->getFileSize(), Members);
+    std::sort(Members.begin(), Members.end());
+    for (Elf64_Half Member : Members) {
+      SegmentSections[Index].push_back(Sections[Member]);
+      SectionSegments[Member].push_back(Seg);
+    }
+
+    if (Seg->getType() == PT_LOAD) {
+      if (Seg->getMemorySize() != 0)
+        LoadsByAddress.push_back({Address, Address + Seg->getMemorySize(), Index});
+      if (Seg->getFileSize() != 0)
+        LoadsByOffset.push_back({Offset, Offset + Seg->getFileSize(), Index});
+    }
+  }
+  std::sort(LoadsByAddress.begin(), LoadsByAddress.end(), isBefore<Interval>);
+  std::sort(LoadsByOffset.begin(), LoadsByOffset.end(), isBefore<Interval>);
+
+  // sections of relocatable objects have no addresses yet
+  if (LoadsByAddress.empty())
+    SectionsByAddress.clear();
+}
+
+// Finds the interval containing a value
+long FileLayoutIndex::find(const std::vector<Interval>& intervals, Elf64_Addr value) {
+  auto Iter = std::upper_bound(intervals.begin(), intervals.end(), value,
+                               [](Elf64_Addr value, const Interval& interval) {
+    return value < interval.Begin;
+  });
+  if (Iter == intervals.begin() || value >= std::prev(Iter)->End)
+    return -1;
+  return std::prev(Iter)->Index;
+}
+
+// Returns the sections of a segment
+const std::vector<std::shared_ptr<Section>>& FileLayoutIndex::getSectionsOfSegment(
+    Elf64_Half segment) const {
+  static const std::vector<std::shared_ptr<Section>> None;
+  return segment < SegmentSections.size() ? SegmentSections[segment] : None;
+}
+
+// Returns the segments of a section
+const std::vector<std::shared_ptr<Segment>>& FileLayoutIndex::getSegmentsOfSection(
+    Elf64_Half section) const {
+  static const std::vector<std::shared_ptr<Segment>> None;
+  return section < SectionSegments.size() ? SectionSegments[section] : None;
+}
+
+// Looks up a section by address
+std::shared_ptr<Section> FileLayoutIndex::findSectionByAddress(Elf64_Addr address) const {
+  long Index = find(SectionsByAddress, address);
+  return Index >= 0 ? Sections[Index] : nullptr;
+}
+
+// Looks up a section by file offset
+std::shared_ptr<Section> FileLayoutIndex::findSectionByOffset(Elf64_Off offset) const {
+  long Index = find(SectionsByOffset, offset);
+  return Index >= 0 ? Sections[Index] : nullptr;
+}
+
+// Looks up a loaded segment by address
+std::shared_ptr<Segment> FileLayoutIndex::findSegmentByAddress(Elf64_Addr address) const {
+  long Index = find(LoadsByAddress, address);
+  return Index >= 0 ? Segments[Index] : nullptr;
+}
+
+// Looks up a loaded segment by file offset
+std::shared_ptr<Segment> FileLayoutIndex::findSegmentByOffset(Elf64_Off offset) const {
+  long Index = find(LoadsByOffset, offset);
+  return Index >= 0 ? Segments[Index] : nullptr;
+}
+
+} // end of namespace libelfpp
@@ -35,23 +35,56 @@
 
 #include "libelfpp/libelfpp.h"
 #include "private_impl.h"
+#include "imagesource.h"
+#include <cstdlib>
 #include <cstring>
+#include <limits>
 
 namespace libelfpp {
 
+/// Number of bytes read from the start of a file at once. This usually covers
+/// the file header and the program header table.
+static const Elf64_Xword InitialReadSize = 4096;
+
 // Implementation of constructor
-ELFFile::ELFFile(const std::string& filename) : Filename(filename) {
-  std::ifstream Input(filename);
-  if (!Input.good()) {
-    throw std::runtime_error("File does not exist!");
+ELFFile::ELFFile(const std::string& filename, const LoadMode mode) :
+    Filename(filename), Mode(mode) {
+  switch (mode) {
+  case LoadMode::Map:
+    Source = std::make_shared<MappedImageSource>(filename);
+    break;
+  case LoadMode::Lazy:
+    Source = std::make_shared<FileImageSource>(filename);
+    break;
+  case LoadMode::Read:
+  default:
+    // sections and segments share one copy of the file in memory
+    Source = std::make_shared<BufferedImageSource>(std::make_shared<FileImageSource>(filename));
+    break;
   }
+  loadFromSource();
+}
+
+// Implementation of constructor for images in memory
+ELFFile::ELFFile(const void* data, const std::size_t size,
+                 const std::shared_ptr<const void>& owner,
+                 const std::string& name) : Filename(name), Mode(LoadMode::Map) {
+  Source = std::make_shared<MemoryImageSource>(data, size, owner);
+  // the image is resident, so section data are views into it like a mapping
+  loadFromSource();
+}
 
+// Parses the file from the image
+void ELFFile::loadFromSource() {
   unsigned char e_ident[EI_NIDENT];
-  Input.seekg(0);
-  Input.read(reinterpret_cast<char*>(&e_ident), sizeof(e_ident));
+  Indexes = std::make_shared<FileIndexes>();
+
+  if (!Source->prefetch({{0, InitialReadSize}})) {
+    throw std::runtime_error("Could not read file!");
+  }
 
   // check if file is ELF file
-  if (Input.gcount() != sizeof(e_ident) ||
+  if (!Source->read(reinterpret_cast<char*>(&e_ident), 0, sizeof(e_ident)) ||
       std::memcmp(e_ident, ELFMAG, std::strlen(ELFMAG)) != 0) {
     throw std::runtime_error("Invalid magic number!");
   }
@@ -81,62 +114,82 @@ ELFFile::ELFFile(const std::string& filename) : Filename(filename) {
   Converter = std::make_shared<EndianessConverter>(IsLittleEndian);
 
   if (Is64Bit) {
-    FileHeader = std::make_shared<ELFHeaderImpl<Elf64_Ehdr>>(Converter, IsLittleEndian, Input);
+    FileHeader = std::make_shared<ELFHeaderImpl<Elf64_Ehdr>>(Converter, IsLittleEndian, *Source);
   } else {
-    FileHeader = std::make_shared<ELFHeaderImpl<Elf32_Ehdr>>(Converter, IsLittleEndian, Input);
+    FileHeader = std::make_shared<ELFHeaderImpl<Elf32_Ehdr>>(Converter, IsLittleEndian, *Source);
   }
 
-  loadSectionsFromFile(Input);
-  loadSegmentsFromFile(Input);
-  Input.close();
+  if (!Source->prefetch({
+      {FileHeader->getSectionHeaderOffset(),
+       Elf64_Xword(FileHeader->getSectionHeaderNumber()) * FileHeader->getSectionHeaderSize()},
+      {FileHeader->getProgramHeaderOffset(),
+       Elf64_Xword(FileHeader->getProgramHeaderNumber()) * FileHeader->getProgramHeaderSize()}})) {
+    throw std::runtime_error("Could not read file!");
+  }
+
+  loadSectionsFromFile();
+  loadSegmentsFromFile();
+
+  // the header tables have been decoded, so their copies are no longer needed
+  Source->releasePrefetched();
+
+  // data is fetched on first access, so touch it now unless loading lazily
+  if (Mode == LoadMode::Read) {
+    for (const auto& Sec : Sections) {
+      Sec->getData();
+    }
+    for (const auto& Seg : Segments) {
+      Seg->getData();
+    }
+  }
 }
 
-// Loads all segmetns from the file stream
-Elf64_Half ELFFile::loadSegmentsFromFile(std::ifstream& stream) {
+// Loads all segmetns from the image
+Elf64_Half ELFFile::loadSegmentsFromFile() {
   Elf64_Half entrySize = FileHeader->getProgramHeaderSize();
   Elf64_Half segmentNumber = FileHeader->getProgramHeaderNumber();
   Elf64_Off offset = FileHeader->getProgramHeaderOffset();
 
   for (Elf64_Half iter = 0; iter < segmentNumber; ++iter) {
     std::shared_ptr<Segment> Seg;
-    Elf64_Off baseOff, endOff, vBaseAddr, vEndAddr;
 
     if (Is64Bit) {
       Seg = std::make_shared<SegmentImpl<Elf64_Phdr>>(Converter);
     } else {
       Seg = std::make_shared<SegmentImpl<Elf32_Phdr>>(Converter);
     }
-    Seg->loadSegment(stream, (std::streamoff) offset + iter * entrySize);
+    Seg->loadSegment(Source, offset + iter * entrySize);
     Seg->setIndex(iter);
     Segments.push_back(Seg);
+  }
 
-    // add associated sections
-    baseOff = Seg->getOffset();
-    endOff = baseOff + Seg->getFileSize();
-    vBaseAddr = Seg->getVirtualAddress();
-    vEndAddr = vBaseAddr + Seg->getMemorySize();
-
-    for (const auto& Section : Sections) {
-      if (Section->getFlags() & SHF_ALLOC) {
-        if (vBaseAddr <= Section->getAddress() &&
-            Section->getAddress() + Section->getSize() <= vEndAddr) {
-          Seg->addSection(Sections[Section->getIndex()]);
-        }
-      } else {
-        if (baseOff <= Section->getOffset() &&
-            Section->getOffset() + Section->getSize() <= endOff) {
-          Seg->addSection(Sections[Section->getIndex()]);
-        }
+  // read the data of all segments at once, bytes shared with sections are
+  // not read again
+  if (Mode == LoadMode::Read) {
+    std::vector<ImageRange> Payloads;
+    for (const auto& Seg : Segments) {
+      if (Seg->getType() != PT_NULL) {
+        Payloads.push_back({Seg->getOffset(), Seg->getFileSize()});
       }
     }
+    if (!Source->prefetch(Payloads)) {
+      throw std::runtime_error("Could not read file!");
+    }
+  }
+
+  // add associated sections
+  Indexes->Layout = std::make_shared<FileLayoutIndex>(Sections, Segments);
+  Indexes->SegmentTails.reset(new FileIndexes::SegmentWindows[Segments.size()]);
+  for (const auto& Seg : Segments) {
+    Seg->setAssociatedSections(Indexes->Layout->getSectionsOfSegment(Seg->getIndex()));
   }
 
   return segmentNumber;
 }
 
 
-// Loads all sections from the file stream
-Elf64_Half ELFFile::loadSectionsFromFile(std::ifstream& stream) {
+// Loads all sections from the image
+Elf64_Half ELFFile::loadSectionsFromFile() {
   Elf64_Half entrySize = FileHeader->getSectionHeaderSize();
   Elf64_Half sectionNumber = FileHeader->getSectionHeaderNumber();
   Elf64_Off offset = FileHeader->getSectionHeaderOffset();
@@ -148,65 +201,101 @@ Elf64_Half ELFFile::loadSectionsFromFile(std::ifstream& stream) {
     } else {
       Sec = std::make_shared<SectionImpl<Elf32_Shdr>>(Converter);
     }
-    Sec->loadSection(stream, (std::streamoff) offset + iter * entrySize);
+    Sec->loadSection(Source, offset + iter * entrySize);
     Sec->setIndex(iter);
     Sections.push_back(Sec);
+    Indexes->SectionsByType[Sec->getType()].push_back(Sec);
+  }
 
-    if (Sec->getType() == SHT_DYNAMIC) {
-      if (FileHeader->is64Bit()) {
-        DynamicSec = DynamicSectionImpl<Elf64_Shdr, Elf64_Dyn>::fromSection(Sec);
-      } else {
-        DynamicSec = DynamicSectionImpl<Elf32_Shdr, Elf32_Dyn>::fromSection(Sec);
+  // read the data of all sections with as few reads as possible
+  if (Mode == LoadMode::Read) {
+    std::vector<ImageRange> Payloads;
+    for (const auto& Sec : Sections) {
+      if (Sec->getType() != SHT_NULL && Sec->getType() != SHT_NOBITS) {
+        Payloads.push_back({Sec->getOffset(), Sec->getSize()});
       }
     }
+    if (!Source->prefetch(Payloads)) {
+      throw std::runtime_error("Could not read file!");
+    }
   }
 
+  // string and symbol sections are created once per section index and
+  // shared by all sections linking to them
+  std::vector<std::shared_ptr<StringSection>> StringSections(Sections.size());
+  std::vector<std::shared_ptr<SymbolSection>> LinkedSymbolSections(Sections.size());
+  auto getStringSection = [&](Elf64_Word index) -> std::shared_ptr<StringSection> {
+    if (index >= Sections.size())
+      return nullptr;
+    if (!StringSections[index]) {
+      if (Is64Bit) {
+        StringSections[index] = StringSectionImpl<Elf64_Shdr>::fromSection(Sections[index]);
+      } else {
+        StringSections[index] = StringSectionImpl<Elf32_Shdr>::fromSection(Sections[index]);
+      }
+    }
+    return StringSections[index];
+  };
+  auto getSymbolSection = [&](Elf64_Word index) -> std::shared_ptr<SymbolSection> {
+    if (index >= Sections.size())
+      return nullptr;
+    if (!LinkedSymbolSections[index]) {
+      auto Str = getStringSection(Sections[index]->getLink());
+      if (Is64Bit) {
+        LinkedSymbolSections[index] = SymbolSectionImpl<Elf64_Shdr, Elf64_Sym>::fromSection(Sections[index], Str);
+      } else {
+        LinkedSymbolSections[index] = SymbolSectionImpl<Elf32_Shdr, Elf32_Sym>::fromSection(Sections[index], Str);
+      }
+    }
+    return LinkedSymbolSections[index];
+  };
+
   // get primary string section
   Elf64_Half StringIndex = FileHeader->getSectionHeaderStringTableIndex();
   if (StringIndex != SHN_UNDEF) {
-    if (FileHeader->is64Bit()) {
-      StrSection = StringSectionImpl<Elf64_Shdr>::fromSection(Sections[StringIndex]);
-    } else {
-      StrSection = StringSectionImpl<Elf32_Shdr>::fromSection(Sections[StringIndex]);
-    }
+    StrSection = getStringSection(StringIndex);
+  }
 
+  if (StrSection) {
+    // name all sections first, typed sections copy the name when created
+    Indexes->SectionsByName.reserve(Sections.size());
     for (const auto& Sec : Sections) {
-      Sec->setName(StrSection->getString(Sec->getNameStringOffset()));
+      StringView Name = StrSection->getStringView(Sec->getNameStringOffset());
+      Sec->setName(Name.str());
+      Indexes->SectionsByName[Name].push_back(Sec);
+    }
+    StrSection->setName(StrSection->getString(StrSection->getNameStringOffset()));
 
-      // get symbol sections in this loop, so we do not need to loop again
+    for (const auto& Sec : Sections) {
       if (Sec->getType() == SHT_DYNSYM || Sec->getType() == SHT_SYMTAB) {
-        std::shared_ptr<SymbolSection> Sym;
-        std::shared_ptr<StringSection> Str;
-
-        if (FileHeader->is64Bit()) {
-          Str = StringSectionImpl<Elf64_Shdr>::fromSection(Sections[Sec->getLink()]);
-          Sym = SymbolSectionImpl<Elf64_Shdr, Elf64_Sym>::fromSection(Sec, Str);
-        } else {
-          Str = StringSectionImpl<Elf32_Shdr>::fromSection(Sections[Sec->getLink()]);
-          Sym = SymbolSectionImpl<Elf32_Shdr, Elf32_Sym>::fromSection(Sec, Str);
-        }
+        auto Sym = getSymbolSection(Sec->getIndex());
         if (Sym)
           SymbolSections.push_back(Sym);
       }
 
       if (Sec->getType() == SHT_REL || Sec->getType() == SHT_RELA) {
         std::shared_ptr<RelocationSection> Reloc;
-        std::shared_ptr<StringSection> Str;
-        std::shared_ptr<SymbolSection> Sym;
-
-        if (FileHeader->is64Bit()) {
-          Str = StringSectionImpl<Elf64_Shdr>::fromSection(Sections[Sections[Sec->getLink()]->getLink()]);
-          Sym = SymbolSectionImpl<Elf64_Shdr, Elf64_Sym>::fromSection(Sections[Sec->getLink()], Str);
+        auto Sym = getSymbolSection(Sec->getLink());
+        if (Is64Bit) {
           Reloc = RelocationSectionImpl<Elf64_Shdr>::fromSection(Sec, Sym, true);
         } else {
-          Str = StringSectionImpl<Elf32_Shdr>::fromSection(Sections[Sections[Sec->getLink()]->getLink()]);
-          Sym = SymbolSectionImpl<Elf32_Shdr, Elf32_Sym>::fromSection(Sections[Sec->getLink()], Str);
           Reloc = RelocationSectionImpl<Elf32_Shdr>::fromSection(Sec, Sym, false);
         }
         if (Reloc)
           RelocSections.push_back(Reloc);
       }
 
+      if (Sec->getType() == SHT_RELR) {
+        std::shared_ptr<RelocationSection> Reloc;
+        if (Is64Bit) {
+          Reloc = RelrSectionImpl<Elf64_Shdr>::fromSection(Sec, FileHeader->getMachine());
+        } else {
+          Reloc = RelrSectionImpl<Elf32_Shdr>::fromSection(Sec, FileHeader->getMachine());
+        }
+        if (Reloc)
+          RelocSections.push_back(Reloc);
+      }
+
       if (Sec->getType() == SHT_NOTE) {
         std::shared_ptr<NoteSection> N;
         if (FileHeader->is64Bit()) {
@@ -218,40 +307,261 @@ Elf64_Half ELFFile::loadSectionsFromFile(std::ifstream& stream) {
           NoteSections.push_back(N);
       }
     }
+  }
 
-    DynamicSec->setName(StrSection->getString(DynamicSec->getNameStringOffset()));
-    StrSection->setName(StrSection->getString(StrSection->getNameStringOffset()));
+  // the dynamic section refers to its string section, named by now
+  for (const auto& Sec : Sections) {
+    if (Sec->getType() == SHT_DYNAMIC) {
+      auto Str = getStringSection(Sec->getLink());
+      if (FileHeader->is64Bit()) {
+        DynamicSec = DynamicSectionImpl<Elf64_Shdr, Elf64_Dyn>::fromSection(Sec, Str);
+      } else {
+        DynamicSec = DynamicSectionImpl<Elf32_Shdr, Elf32_Dyn>::fromSection(Sec, Str);
+      }
+    }
   }
 
   return sectionNumber;
 }
 
-// return needed libraries
-const std::vector<std::string> ELFFile::getNeededLibraries() const {
-  std::shared_ptr<StringSection> StrSec;
-
-  try {
-    if (FileHeader->is64Bit()) {
-      StrSec =
-          std::make_shared<StringSectionImpl<Elf64_Shdr> >(*dynamic_cast<SectionImpl<
-              Elf64_Shdr> *>(sections().at(DynamicSec->getLink()).get()));
+// return the layout of sections and segments
+const std::shared_ptr<const FileLayoutIndex> ELFFile::getLayoutIndex() const {
+  return Indexes->Layout;
+}
+
+// return the first section with a name
+const std::shared_ptr<Section> ELFFile::getSectionByName(const StringView& name) const {
+  auto Iter = Indexes->SectionsByName.find(name);
+  return Iter != Indexes->SectionsByName.end() ? Iter->second.front() : nullptr;
+}
+
+// return all sections with a name
+const std::vector<std::shared_ptr<Section>>& ELFFile::getSectionsByName(const StringView& name) const {
+  static const std::vector<std::shared_ptr<Section>> NoSections;
+  auto Iter = Indexes->SectionsByName.find(name);
+  return Iter != Indexes->SectionsByName.end() ? Iter->second : NoSections;
+}
+
+// return all sections of a type
+const std::vector<std::shared_ptr<Section>>& ELFFile::getSectionsByType(Elf64_Word type) const {
+  static const std::vector<std::shared_ptr<Section>> NoSections;
+  auto Iter = Indexes->SectionsByType.find(type);
+  return Iter != Indexes->SectionsByType.end() ? Iter->second : NoSections;
+}
+
+// translate a virtual address to a file offset
+bool ELFFile::addressToOffset(Elf64_Addr address, Elf64_Off& offset) const {
+  auto Seg = Indexes->Layout->findSegmentByAddress(address);
+  if (!Seg || address - Seg->getVirtualAddress() >= Seg->getFileSize())
+    return false;
+  offset = Seg->getOffset() + (address - Seg->getVirtualAddress());
+  return true;
+}
+
+// translate a file offset to a virtual address
+bool ELFFile::offsetToAddress(Elf64_Off offset, Elf64_Addr& address) const {
+  auto Seg = Indexes->Layout->findSegmentByOffset(offset);
+  if (!Seg)
+    return false;
+  address = Seg->getVirtualAddress() + (offset - Seg->getOffset());
+  return true;
+}
+
+/// Returns a copy of the bytes at offsets \p start to \p start + \p size of
+/// the memory image of a segment, whose first \p fileSize bytes are \p data
+/// and whose remaining bytes up to \p limit are zero. Windows grow
+/// geometrically, so that repeated requests create few of them.
+///
+/// \param windows The windows of the segment
+/// \param start Offset of the first byte
+/// \param size Number of bytes
+/// \param data The file data of the segment
+/// \param fileSize Number of bytes of \p data
+/// \param limit Size of the memory image
+/// \return Pointer to the bytes or \p nullptr if they cannot be allocated
+static const char* getWindow(FileIndexes::SegmentWindows& windows, Elf64_Xword start,
+                             Elf64_Xword size, const char* data, Elf64_Xword fileSize,
+                             Elf64_Xword limit) {
+  typedef FileIndexes::MemoryWindow Window;
+  const Elf64_Xword End = start + size;
+  auto covers = [start, End](const Window* window) {
+    return window && window->Start <= start && End <= window->Start + window->Size;
+  };
+  const Window* Current = windows.Current.load(std::memory_order_acquire);
+  if (covers(Current))
+    return Current->Memory.get() + (start - Current->Start);
+
+  std::lock_guard<std::mutex> Guard(windows.Lock);
+  Current = windows.Current.load(std::memory_order_relaxed);
+  if (covers(Current))
+    return Current->Memory.get() + (start - Current->Start);
+
+  // large zero-filled blocks are mapped lazily by calloc, so only the pages
+  // that are read take memory
+  auto allocate = [data, fileSize](Elf64_Xword first, Elf64_Xword last) {
+    std::unique_ptr<Window> Result;
+    if (last - first >= std::numeric_limits<std::size_t>::max())
+      return Result;
+    char* Memory = static_cast<char*>(std::calloc(1, std::max<Elf64_Xword>(last - first, 1)));
+    if (!Memory)
+      return Result;
+    Result.reset(new Window{first, last - first, {Memory, std::free}});
+    if (first < fileSize)
+      std::memcpy(Memory, data + first, std::min(fileSize, last) - first);
+    return Result;
+  };
+
+  std::unique_ptr<Window> Created;
+  if (Current) {
+    const Elf64_Xword CurrentEnd = Current->Start + Current->Size;
+    Created = allocate(std::min(start, Current->Start - std::min(Current->Start, Current->Size)),
+                       std::max(End, CurrentEnd + std::min(Current->Size, limit - CurrentEnd)));
+  }
+  if (!Created)
+    Created = allocate(start, End);
+  if (!Created)
+    return nullptr;
+
+  windows.Windows.push_back(std::move(Created));
+  Current = windows.Windows.back().get();
+  windows.Current.store(Current, std::memory_order_release);
+  return Current->Memory.get() + (start - Current->Start);
+}
+
+// return the data at a range of virtual addresses
+const char* ELFFile::getDataAtAddress(Elf64_Addr address, Elf64_Xword size) const {
+  auto Seg = Indexes->Layout->findSegmentByAddress(address);
+  if (!Seg)
+    return nullptr;
+  const Elf64_Xword Start = address - Seg->getVirtualAddress();
+  if (size > Seg->getMemorySize() - Start)
+    return nullptr;
+
+  // the data pointer is null if the bytes of the segment could not be read
+  const Elf64_Xword FileSize = Seg->getFileSize();
+  const char* Data = Seg->getDataPointer();
+  if (Start < FileSize && !Data)
+    return nullptr;
+  if (Start + size <= FileSize)
+    return Data + Start;
+
+  // only the requested bytes of the zero-filled tail are provided
+  if (Start >= FileSize)
+    return getWindow(Indexes->Zeros, 0, size, nullptr, 0, std::numeric_limits<Elf64_Xword>::max());
+  return getWindow(Indexes->SegmentTails[Seg->getIndex()], Start, size, Data, FileSize,
+                   Seg->getMemorySize());
+}
+
+// return the index for looking up symbols by address
+const std::shared_ptr<const SymbolAddressIndex> ELFFile::getAddressIndex() const {
+  std::call_once(Indexes->AddressIndexBuilt, [this]() {
+    Indexes->AddressIndex = std::make_shared<SymbolAddressIndex>(SymbolSections);
+  });
+  return Indexes->AddressIndex;
+}
+
+// return the index for looking up symbols by name
+const std::shared_ptr<const SymbolNameIndex> ELFFile::getNameIndex() const {
+  std::call_once(Indexes->NameIndexBuilt, [this]() {
+    Indexes->NameIndex = std::make_shared<SymbolNameIndex>(SymbolSections);
+  });
+  return Indexes->NameIndex;
+}
+
+// return the lookup of dynamic symbols by name
+const std::shared_ptr<const SymbolHashTable> ELFFile::getSymbolHashTable() const {
+  std::call_once(Indexes->HashTableBuilt, [this]() {
+    // the GNU hash table is preferred, like the dynamic linker does
+    std::shared_ptr<Section> Hash;
+    for (const auto& Sec : Sections) {
+      if (Sec->getType() == SHT_GNU_HASH || (Sec->getType() == SHT_HASH && !Hash)) {
+        Hash = Sec;
+      }
+    }
+    if (!Hash)
+      return;
+
+    std::shared_ptr<SymbolSection> Symbols;
+    for (const auto& Sym : SymbolSections) {
+      if (Sym->getIndex() == Hash->getLink())
+        Symbols = Sym;
+    }
+    if (!Symbols)
+      return;
+
+    const char* Data = nullptr;
+    if (Is64Bit) {
+      Data = std::dynamic_pointer_cast<SectionImpl<Elf64_Shdr>>(Hash)->getDataPointer();
     } else {
-      StrSec =
-          std::make_shared<StringSectionImpl<Elf32_Shdr> >(*dynamic_cast<SectionImpl<
-              Elf32_Shdr> *>(sections().at(DynamicSec->getLink()).get()));
+      Data = std::dynamic_pointer_cast<SectionImpl<Elf32_Shdr>>(Hash)->getDataPointer();
     }
-  } catch (const std::out_of_range&) {
-    return {};
-  }
-  if (!StrSec) return {};
+    Indexes->HashTable = std::make_shared<SymbolHashTable>(Hash, Data, Symbols, *Converter, Is64Bit);
+  });
+  return Indexes->HashTable;
+}
+
+// look up a dynamic symbol by name
+const SymbolLookupResult ELFFile::findDynamicSymbol(const StringView& name) const {
+  auto Table = getSymbolHashTable();
+  if (!Table)
+    return {false, 0, SymbolRef()};
+  return Table->find(name);
+}
 
-  std::vector<std::string> result;
-  for (const auto& entry : DynamicSec->getAllEntries()) {
-    if (entry.tag == DT_NEEDED) {
-      result.push_back(StrSec->getString(static_cast<Elf64_Word>(entry.value)));
+// return statistics about reads from the file
+const IOStatistics ELFFile::getIOStatistics() const {
+  return {Source->getReadCalls(), Source->getBytesRead()};
+}
+
+// return the symbol versions of the dynamic symbols
+const std::shared_ptr<const SymbolVersionTable> ELFFile::getSymbolVersionTable() const {
+  std::call_once(Indexes->VersionTableBuilt, [this]() {
+    const auto& Versym = getSectionsByType(SHT_GNU_versym);
+    if (Versym.empty())
+      return;
+
+    std::shared_ptr<SymbolSection> Symbols;
+    for (const auto& Sym : SymbolSections) {
+      if (Sym->getIndex() == Versym.front()->getLink())
+        Symbols = Sym;
     }
-  }
-  return result;
+    if (!Symbols)
+      return;
+
+    auto getData = [this](const std::vector<std::shared_ptr<Section>>& sections) {
+      SymbolVersionTable::SectionData Result = {nullptr, 0, 0};
+      if (sections.empty())
+        return Result;
+      if (Is64Bit) {
+        Result.Data = std::dynamic_pointer_cast<SectionImpl<Elf64_Shdr>>(sections.front())->getDataPointer();
+      } else {
+        Result.Data = std::dynamic_pointer_cast<SectionImpl<Elf32_Shdr>>(sections.front())->getDataPointer();
+      }
+      Result.Size = sections.front()->getSize();
+      Result.Count = sections.front()->getInfo();
+      return Result;
+    };
+    Indexes->VersionTable = std::make_shared<SymbolVersionTable>(
+        Symbols, getData(Versym), getData(getSectionsByType(SHT_GNU_verdef)),
+        getData(getSectionsByType(SHT_GNU_verneed)), *Converter);
+  });
+  return Indexes->VersionTable;
+}
+
+// return needed libraries
+const std::vector<std::string>& ELFFile::getNeededLibraries() const {
+  std::call_once(Indexes->NeededLibrariesBuilt, [this]() {
+    if (!DynamicSec || !DynamicSec->getStringSection())
+      return;
+    auto StrSec = DynamicSec->getStringSection();
+    for (const auto& Entry : DynamicSec->entries()) {
+      if (Entry.tag == DT_NULL)
+        break;
+      if (Entry.tag == DT_NEEDED)
+        Indexes->NeededLibraries.push_back(StrSec->getString(static_cast<Elf64_Word>(Entry.value)));
+    }
+  });
+  return Indexes->NeededLibraries;
 }
 
 } // end of namespace libelfpp
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        nameindex.cpp
+ * \brief       Source file implementing the index for looking up symbols by
+ *              name
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p SymbolNameIndex.
+ */
+
+#include "libelfpp/nameindex.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace libelfpp {
+
+// Indexes the symbols
+SymbolNameIndex::SymbolNameIndex(const std::vector<std::shared_ptr<SymbolSection>>& sections) :
+    Sections(sections), Entries(), GroupStarts(), Slots(), Mask(0) {
+  std::size_t Total = 0;
+  for (const auto& Section : Sections) {
+    if (Section)
+      Total += Section->symbols().size();
+  }
+  if (Total > UINT32_MAX / 4)
+    throw std::runtime_error("Too many symbols for a name index");
+
+  // at most half of the slots are used, which keeps probe sequences short
+  std::size_t SlotCount = 1;
+  while (SlotCount < 2 * Total)
+    SlotCount <<= 1;
+  Slots.assign(SlotCount, Slot{0, 0});
+  Mask = static_cast<uint32_t>(SlotCount - 1);
+
+  // one pass over the symbols assigns every name its group
+  std::vector<IndexedSymbol> Found;
+  std::vector<uint32_t> GroupOf;
+  std::vector<uint32_t> GroupFirst;
+  std::vector<uint32_t> GroupSize;
+  Found.reserve(Total);
+  GroupOf.reserve(Total);
+  for (const auto& Section : Sections) {
+    if (!Section)
+      continue;
+
+    Elf64_Xword Index = 0;
+    for (auto Symbol : Section->symbols()) {
+      if (!Symbol.name.empty()) {
+        const uint32_t Hash = hashName(Symbol.name);
+        uint32_t Pos = Hash & Mask;
+        while (Slots[Pos].Group != 0 &&
+               (Slots[Pos].Hash != Hash ||
+                Found[GroupFirst[Slots[Pos].Group - 1]].Symbol.name != Symbol.name)) {
+          Pos = (Pos + 1) & Mask;
+        }
+        if (Slots[Pos].Group == 0) {
+          GroupFirst.push_back(static_cast<uint32_t>(Found.size()));
+          GroupSize.push_back(0);
+          Slots[Pos] = Slot{Hash, static_cast<uint32_t>(GroupFirst.size())};
+        }
+        const uint32_t Group = Slots[Pos].Group - 1;
+        ++GroupSize[Group];
+        GroupOf.push_back(Group);
+        Found.push_back({Symbol, Section->getIndex(), Index});
+      }
+      ++Index;
+    }
+  }
+
+  // sorting the groups by name makes names with a common prefix consecutive
+  const uint32_t Groups = static_cast<uint32_t>(GroupFirst.size());
+  std::vector<uint32_t> Order(Groups);
+  std::iota(Order.begin(), Order.end(), 0);
+  std::sort(Order.begin(), Order.end(), [&](uint32_t lhs, uint32_t rhs) {
+    return Found[GroupFirst[lhs]].Symbol.name < Found[GroupFirst[rhs]].Symbol.name;
+  });
+
+  std::vector<uint32_t> Rank(Groups);
+  GroupStarts.resize(Groups + 1);
+  uint32_t Start = 0;
+  for (uint32_t Pos = 0; Pos < Groups; ++Pos) {
+    Rank[Order[Pos]] = Pos;
+    GroupStarts[Pos] = Start;
+    Start += GroupSize[Order[Pos]];
+  }
+  GroupStarts[Groups] = Start;
+
+  // place the symbols of every group behind each other, keeping their order
+  std::vector<uint32_t> Next(GroupStarts.begin(), GroupStarts.end() - 1);
+  Entries.resize(Found.size());
+  for (std::size_t Pos = 0; Pos < Found.size(); ++Pos) {
+    Entries[Next[Rank[GroupOf[Pos]]]++] = Found[Pos];
+  }
+  for (auto& S : Slots) {
+    if (S.Group != 0)
+      S.Group = Rank[S.Group - 1] + 1;
+  }
+}
+
+// Computes the hash of a name
+uint32_t SymbolNameIndex::hashName(const StringView& name) {
+  uint32_t Hash = 2166136261u;
+  for (char C : name) {
+    Hash ^= static_cast<unsigned char>(C);
+    Hash *= 16777619u;
+  }
+  return Hash;
+}
+
+// Looks up the symbols with a name
+IndexedSymbolRange SymbolNameIndex::find(const StringView& name) const {
+  const uint32_t Hash = hashName(name);
+  for (uint32_t Pos = Hash & Mask; Slots[Pos].Group != 0; Pos = (Pos + 1) & Mask) {
+    if (Slots[Pos].Hash == Hash && getGroupName(Slots[Pos].Group - 1) == name)
+      return getGroup(Slots[Pos].Group - 1);
+  }
+  return IndexedSymbolRange();
+}
+
+// Looks up the symbols with a name prefix
+IndexedSymbolRange SymbolNameIndex::findPrefix(const StringView& prefix) const {
+  const uint32_t Groups = static_cast<uint32_t>(getNameCount());
+  uint32_t First = 0;
+  uint32_t Count = Groups;
+  while (Count > 0) {
+    uint32_t Step = Count / 2;
+    if (getGroupName(First + Step) < prefix) {
+      First += Step + 1;
+      Count -= Step + 1;
+    } else {
+      Count = Step;
+    }
+  }
+
+  // all names starting with the prefix follow the first one that is not less
+  uint32_t Last = First;
+  Count = Groups - First;
+  while (Count > 0) {
+    uint32_t Step = Count / 2;
+    if (getGroupName(Last + Step).startsWith(prefix)) {
+      Last += Step + 1;
+      Count -= Step + 1;
+    } else {
+      Count = Step;
+    }
+  }
+  return IndexedSymbolRange(Entries.data() + GroupStarts[First],
+                            Entries.data() + GroupStarts[Last]);
+}
+
+} // end of namespace libelfpp
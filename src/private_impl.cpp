@@ -184,7 +184,9 @@ std::map<unsigned int, const std::string> ELFMachineStrings = {
   {EM_CLOUDSHIELD, "CloudShield architecture family"},
   {EM_COREA_1ST, "KIPO-KAIST Core-A 1st generation processor family"},
   {EM_COREA_2ND, "KIPO-KAIST Core-A 2nd generation processor family"},
+#ifdef EM_ARC_COMPACT2
   {EM_ARC_COMPACT2, "Synopsys ARCompact V2"},
+#endif
   {EM_OPEN8, "Open8 8-bit RISC soft processor core"},
   {EM_RL78, "Renesas RL78 family"},
   {EM_VIDEOCORE5, "Broadcom VideoCore V processor"},
@@ -275,6 +277,7 @@ std::map<unsigned int, const std::string> ELFSectionTypeStrings = {
     {SHT_PREINIT_ARRAY, "PREINIT_ARRAY"},
     {SHT_GROUP, "GROUP"},
     {SHT_SYMTAB_SHNDX, "SYMTAB_SHDNX"},
+    {SHT_RELR, "RELR"},
     {SHT_GNU_ATTRIBUTES, "GNU_ATTR"},
     {SHT_GNU_HASH, "GNU_HASH"},
     {SHT_GNU_verdef, "GNU_VERDEF"},
@@ -287,6 +290,22 @@ std::map<unsigned int, const std::string> ELFSectionTypeStrings = {
     {SHT_SUNW_syminfo, "SUNW_SYMINFO"}
 };
 
+std::map<unsigned int, const Elf64_Word> RelativeRelocationTypes = {
+    {EM_386, R_386_RELATIVE},
+    {EM_68K, R_68K_RELATIVE},
+    {EM_SPARC, R_SPARC_RELATIVE},
+    {EM_SPARCV9, R_SPARC_RELATIVE},
+    {EM_PPC, R_PPC_RELATIVE},
+    {EM_PPC64, R_PPC64_RELATIVE},
+    {EM_S390, R_390_RELATIVE},
+    {EM_ARM, R_ARM_RELATIVE},
+    {EM_X86_64, R_X86_64_RELATIVE},
+    {EM_AARCH64, R_AARCH64_RELATIVE},
+    {EM_RISCV, R_RISCV_RELATIVE},
+    {EM_LOONGARCH, R_LARCH_RELATIVE},
+    {EM_ALPHA, R_ALPHA_RELATIVE}
+};
+
 std::map<unsigned int, const char> SectionFlagChars {
     {SHF_WRITE, 'W'},
     {SHF_ALLOC, 'A'},
@@ -40,7 +40,20 @@
 #include "libelfpp/fileheader.h"
 #include "libelfpp/segment.h"
 #include "libelfpp/section.h"
+#include "libelfpp/elfview.h"
+#include "libelfpp/addressindex.h"
+#include "libelfpp/layoutindex.h"
+#include "libelfpp/nameindex.h"
+#include "libelfpp/symbolhash.h"
+#include "libelfpp/symbolversion.h"
+#include "imagesource.h"
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <algorithm>
 #include <iostream>
 
@@ -58,36 +71,102 @@ extern std::map<unsigned int, const std::string> SegmentTypeStrings;
 /// Holds strings representing section types
 extern std::map<unsigned int, const std::string> ELFSectionTypeStrings;
 
+/// Maps ELF machines to the type of their relative relocations
+extern std::map<unsigned int, const Elf64_Word> RelativeRelocationTypes;
+
 /// Holds chars representing section flags
 extern std::map<unsigned int, const char> SectionFlagChars;
 
-/// Template class for the two types of \p Elf_Ehdr
+/// Minimum number of table entries worth decoding on a thread of its own
+static const Elf64_Xword MinEntriesPerThread = 4096;
+
+/// Decodes a table of fixed-size entries in chunks on several threads. The
+/// chunks are contiguous and of equal size and the calling thread decodes
+/// the first one. If a thread can not be started, its chunk is decoded on
+/// the calling thread.
+///
+/// \tparam F Type of the function decoding a chunk
+/// \param count Number of entries
+/// \param threads Maximum number of threads, 0 for one per hardware thread
+/// \param decodeChunk Called as \p decodeChunk(first, count) for every chunk
+template<class F>
+void decodeInChunks(Elf64_Xword count, unsigned int threads, const F& decodeChunk) {
+  Elf64_Xword Threads = threads ? threads : std::thread::hardware_concurrency();
+  Threads = std::max<Elf64_Xword>(1, std::min(Threads, count / MinEntriesPerThread));
+  const Elf64_Xword Chunk = (count + Threads - 1) / Threads;
+
+  std::vector<std::thread> Workers;
+  for (Elf64_Xword First = Chunk; First < count; First += Chunk) {
+    const Elf64_Xword Count = std::min(Chunk, count - First);
+    try {
+      Workers.emplace_back([&decodeChunk, First, Count]() { decodeChunk(First, Count); });
+    } catch (const std::system_error&) {
+      decodeChunk(First, Count);
+    }
+  }
+  decodeChunk(0, std::min(Chunk, count));
+  for (auto& Worker : Workers) {
+    Worker.join();
+  }
+}
+
+/// Converts the fields of an ELF file header to the host's byte order.
 ///
 /// \tparam T The type of ELF header
+/// \param converter The converter to use
+/// \param header The header to convert
 template<class T>
-struct ELFHeaderImplTypes;
-
-/// Template implement type for 32 Bit ELFs
-template<> struct
-ELFHeaderImplTypes<Elf32_Ehdr> {
-  /// Defines the type of program headers
-  typedef Elf32_Phdr Phdr_t;
-  /// Defines the type of section headers
-  typedef Elf32_Shdr Shdr_t;
-  /// Holds the header's class
-  static const bool is64Bit = false;
-};
-
-/// Template implement type for 64 Bit ELFs
-template<> struct
-ELFHeaderImplTypes<Elf64_Ehdr> {
-  /// Defines the type of program headers
-  typedef Elf64_Phdr Phdr_t;
-  /// Defines the type of section headers
-  typedef Elf64_Shdr Shdr_t;
-  /// Holds the header's class
-  static const bool is64Bit = true;
-};
+void convertFileHeader(const EndianessConverter& converter, T& header) {
+  header.e_type = converter(header.e_type);
+  header.e_machine = converter(header.e_machine);
+  header.e_version = converter(header.e_version);
+  header.e_entry = converter(header.e_entry);
+  header.e_phoff = converter(header.e_phoff);
+  header.e_shoff = converter(header.e_shoff);
+  header.e_flags = converter(header.e_flags);
+  header.e_ehsize = converter(header.e_ehsize);
+  header.e_phentsize = converter(header.e_phentsize);
+  header.e_phnum = converter(header.e_phnum);
+  header.e_shentsize = converter(header.e_shentsize);
+  header.e_shnum = converter(header.e_shnum);
+  header.e_shstrndx = converter(header.e_shstrndx);
+}
+
+/// Converts the fields of a program header to the host's byte order.
+///
+/// \tparam T The type of program header
+/// \param converter The converter to use
+/// \param header The header to convert
+template<class T>
+void convertProgramHeader(const EndianessConverter& converter, T& header) {
+  header.p_type = converter(header.p_type);
+  header.p_offset = converter(header.p_offset);
+  header.p_vaddr = converter(header.p_vaddr);
+  header.p_paddr = converter(header.p_paddr);
+  header.p_filesz = converter(header.p_filesz);
+  header.p_memsz = converter(header.p_memsz);
+  header.p_flags = converter(header.p_flags);
+  header.p_align = converter(header.p_align);
+}
+
+/// Converts the fields of a section header to the host's byte order.
+///
+/// \tparam T The type of section header
+/// \param converter The converter to use
+/// \param header The header to convert
+template<class T>
+void convertSectionHeader(const EndianessConverter& converter, T& header) {
+  header.sh_name = converter(header.sh_name);
+  header.sh_type = converter(header.sh_type);
+  header.sh_flags = converter(header.sh_flags);
+  header.sh_addr = converter(header.sh_addr);
+  header.sh_offset = converter(header.sh_offset);
+  header.sh_size = converter(header.sh_size);
+  header.sh_link = converter(header.sh_link);
+  header.sh_info = converter(header.sh_info);
+  header.sh_addralign = converter(header.sh_addralign);
+  header.sh_entsize = converter(header.sh_entsize);
+}
 
 /// Template implementation of ELF header.
 ///
@@ -96,7 +175,7 @@ template<class T>
 class ELFHeaderImpl final : public ELFFileHeader {
 
 private:
-  /// Holds the file's header
+  /// Holds the file's header in host byte order
   T Header;
   /// Holds a pointer to an \p EndianessConverter
   const std::shared_ptr<EndianessConverter> Converter;
@@ -107,9 +186,9 @@ public:
   ///
   /// \param converter A Pointer to a instance of \p EndianessConverter
   /// \param encoding The encoding to use
-  /// \param stream The file stream to load the header from
+  /// \param source The image to load the header from
   ELFHeaderImpl(const std::shared_ptr<EndianessConverter> converter,
-                const bool isLittleEndian, std::ifstream &stream) :
+                const bool isLittleEndian, const ImageSource& source) :
       Converter(converter) {
 
     std::fill_n(reinterpret_cast<char *>(&Header), sizeof(Header), '\0');
@@ -118,7 +197,7 @@ public:
     Header.e_ident[EI_MAG2] = ELFMAG[2];
     Header.e_ident[EI_MAG3] = ELFMAG[3];
     Header.e_ident[EI_CLASS] =
-        ELFHeaderImplTypes<T>::is64Bit ? ELFCLASS64 : ELFCLASS32;
+        ELFClassTypes<T>::is64Bit ? ELFCLASS64 : ELFCLASS32;
     Header.e_ident[EI_DATA] = isLittleEndian ? ELFDATA2LSB : ELFDATA2MSB;
     Header.e_ident[EI_VERSION] = EV_CURRENT;
     Header.e_version = EV_CURRENT;
@@ -126,33 +205,36 @@ public:
     Header.e_ehsize = (sizeof(Header));
     Header.e_ehsize = (*Converter)(Header.e_ehsize);
     Header.e_shstrndx = (*Converter)((Elf32_Half) 1);
-    Header.e_phentsize = sizeof(typename ELFHeaderImplTypes<T>::Phdr_t);
+    Header.e_phentsize = sizeof(typename ELFClassTypes<T>::Phdr_t);
     Header.e_phentsize = (*Converter)(Header.e_phentsize);
-    Header.e_shentsize = sizeof(typename ELFHeaderImplTypes<T>::Shdr_t);
+    Header.e_shentsize = sizeof(typename ELFClassTypes<T>::Shdr_t);
     Header.e_shentsize = (*Converter)(Header.e_shentsize);
 
-    stream.seekg(0);
-    stream.read(reinterpret_cast<char *>(&Header), sizeof(Header));
+    if (!source.read(reinterpret_cast<char *>(&Header), 0, sizeof(Header))) {
+      throw std::runtime_error("Invalid ELF header!");
+    }
+    // the header is kept in host byte order, so the getters need not convert
+    convertFileHeader(*Converter, Header);
   }
 
   // Returns the ELF file's class
   bool is64Bit() const {
-    return ((*Converter) (Header.e_ident[EI_CLASS]) == ELFCLASS64);
+    return (Header.e_ident[EI_CLASS] == ELFCLASS64);
   }
 
   // Returns the ELF file's version.
   unsigned int getVersion() const {
-    return static_cast<unsigned int>((*Converter) (Header.e_version));
+    return static_cast<unsigned int>(Header.e_version);
   }
 
   // Returns the ELF file's encoding
   bool isLittleEndian() const {
-    return ((*Converter) (Header.e_ident[EI_DATA]) == ELFDATA2LSB);
+    return (Header.e_ident[EI_DATA] == ELFDATA2LSB);
   }
 
   // Returns the ELF file's ABI.
   unsigned int getABI() const {
-    return static_cast<unsigned int>((*Converter) (Header.e_ident[EI_OSABI]));
+    return static_cast<unsigned int>(Header.e_ident[EI_OSABI]);
   }
 
   // Returns the ELF file's ABI as string.
@@ -166,12 +248,12 @@ public:
 
   // Returns the ELF file's type.
   unsigned int getELFType() const {
-    return static_cast<unsigned int>((*Converter) (Header.e_type));
+    return static_cast<unsigned int>(Header.e_type);
   }
 
   // Returns the ELF file's type as string.
   const std::string getELFTypeString() const {
-    switch ((*Converter) (Header.e_type)) {
+    switch (Header.e_type) {
     case ET_NONE:
       return "None";
     case ET_REL:
@@ -189,7 +271,7 @@ public:
 
   // Returns the ELF file's machine architecture.
   unsigned int getMachine() const {
-    return static_cast<unsigned int>((*Converter) (Header.e_machine));
+    return static_cast<unsigned int>(Header.e_machine);
   }
 
   // Returns the ELF file's machine architecture as string.
@@ -203,52 +285,52 @@ public:
 
   // Returns the ELF file's entry point.
   Elf64_Addr getEntryPoint() const {
-    return (*Converter) (Header.e_entry);
+    return Header.e_entry;
   }
 
   // Returns the ELF file's section header number.
   Elf64_Half getSectionHeaderNumber() const {
-    return (*Converter) (Header.e_shnum);
+    return Header.e_shnum;
   }
 
   // Returns the ELF file's section header offset.
   Elf64_Off getSectionHeaderOffset() const {
-    return (*Converter) (Header.e_shoff);
+    return Header.e_shoff;
   }
 
   // Returns the size of the section headers.
   Elf64_Half getSectionHeaderSize() const {
-    return (*Converter) (Header.e_shentsize);
+    return Header.e_shentsize;
   }
 
   // Returns the ELF file's program header number.
   Elf64_Half getProgramHeaderNumber() const {
-    return (*Converter) (Header.e_phnum);
+    return Header.e_phnum;
   }
 
   // Returns the ELF file's program header offset.
   Elf64_Off getProgramHeaderOffset() const {
-    return (*Converter) (Header.e_phoff);
+    return Header.e_phoff;
   }
 
   // Returns the size of the program headers.
   Elf64_Half getProgramHeaderSize() const {
-    return (*Converter) (Header.e_phentsize);
+    return Header.e_phentsize;
   }
 
   // Returns the flags field of the file header.
   Elf64_Word getFlags() const {
-    return (*Converter) (Header.e_flags);
+    return Header.e_flags;
   }
 
   // Returns the size of the file header in bytes.
   Elf64_Half getHeaderSize() const {
-    return (*Converter) (Header.e_ehsize);
+    return Header.e_ehsize;
   }
 
   // Returns the ELF file's section header's string table index.
   Elf64_Half getSectionHeaderStringTableIndex() const {
-    return (*Converter) (Header.e_shstrndx);
+    return Header.e_shstrndx;
   }
 }; // end of class ELFHeaderImpl
 
@@ -260,12 +342,12 @@ template<class T>
 class SegmentImpl final : public Segment {
 
 private:
-  /// The header of this segment
+  /// The header of this segment in host byte order
   T Header;
   /// The index of this segment
   Elf64_Half Index;
-  /// The data associated with this segment
-  std::string Data;
+  /// The data associated with this segment, fetched on first access
+  std::shared_ptr<LazyRange> Data;
   /// Pointer to an instance of \p EndianessConverter
   const std::shared_ptr<EndianessConverter> Converter;
   /// Holds pointers to associated sections
@@ -276,13 +358,13 @@ public:
   ///
   /// \param converter Pointer to an instance of \p EndianessConverter
   SegmentImpl(const std::shared_ptr<EndianessConverter> converter) :
-      Converter(converter), Sections(), Data("") {
+      Converter(converter), Sections(), Data() {
     std::fill_n(reinterpret_cast<char*>(&Header), sizeof(Header), '\0');
   }
 
   /// Destructor of \p SectionImpl.
   ~SegmentImpl() {
-    Data.clear();
+    Data.reset();
     Sections.clear();
   }
 
@@ -293,7 +375,7 @@ public:
 
   // Returns type of segment
   inline Elf64_Word getType() const {
-    return (*Converter) (Header.p_type);
+    return Header.p_type;
   }
 
   // Returns type of segment as string
@@ -307,7 +389,7 @@ public:
 
   // Return flags of segment
   Elf64_Word getFlags() const {
-    return (*Converter) (Header.p_flags);
+    return Header.p_flags;
   }
 
   // Return a string representing the flags of segment
@@ -322,42 +404,49 @@ public:
 
   // Returns address alignment of the segment
   Elf64_Xword getAddressAlignment() const {
-    return (*Converter) (Header.p_align);
+    return Header.p_align;
   }
 
   // Returns virtual address of segment
   Elf64_Addr getVirtualAddress() const {
-    return (*Converter) (Header.p_vaddr);
+    return Header.p_vaddr;
   }
 
   // Returns physical address of segment
   Elf64_Addr getPhysicalAddress() const {
-    return (*Converter) (Header.p_paddr);
+    return Header.p_paddr;
   }
 
   // Returns filesz member
   Elf64_Xword getFileSize() const {
-    return (*Converter) (Header.p_filesz);
+    return Header.p_filesz;
   }
 
   // Returns memsz member
   Elf64_Xword getMemorySize() const {
-    return (*Converter) (Header.p_memsz);
+    return Header.p_memsz;
   }
 
   // Returns offset of segment
   Elf64_Off getOffset() const {
-    return (*Converter) (Header.p_offset);
+    return Header.p_offset;
   }
 
   // Returns segment data
   const char* getData() const {
-    return Data.c_str();
+    const char* Result = getDataPointer();
+    return Result ? Result : "";
+  }
+
+  // Returns segment data or nullptr if it could not be read
+  const char* getDataPointer() const {
+    return Data ? Data->get() : nullptr;
   }
 
   // Returns segment data as string
   const std::string getDataString() const {
-    return Data;
+    const char* Result = Data ? Data->get() : nullptr;
+    return Result ? std::string(Result, getFileSize()) : std::string();
   }
 
   // Return section number of segment
@@ -372,22 +461,14 @@ public:
 
 protected:
   // loads the segment from file
-  void loadSegment(std::ifstream& stream, const std::streampos offset) {
-    stream.seekg(offset);
-    stream.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+  void loadSegment(const std::shared_ptr<ImageSource>& source, const Elf64_Off offset) {
+    std::fill_n(reinterpret_cast<char*>(&Header), sizeof(Header), '\0');
+    source->read(reinterpret_cast<char*>(&Header), offset, sizeof(Header));
+    convertProgramHeader(*Converter, Header);
 
     Elf64_Xword Size = getFileSize();
     if (getType() != PT_NULL && Size != 0) {
-      try {
-        Data = std::string(Size, ' ');
-      } catch (std::bad_alloc&) {
-        Data = "";
-        Size = 0;
-      }
-      if (!Data.empty()) {
-        stream.seekg((*Converter) (Header.p_offset));
-        stream.read(&Data[0], Size);
-      }
+      Data = std::make_shared<LazyRange>(source, getOffset(), Size);
     }
   }
 
@@ -396,14 +477,9 @@ protected:
     Index = index;
   }
 
-  // add associated section
-  Elf64_Half addSection(const std::shared_ptr<Section>& section) {
-    // The vector will be so small, that the overhead of an unordered_set would
-    // be higher than searching the vector for every insert
-    if (std::find(Sections.begin(), Sections.end(), section) == Sections.end()) {
-      Sections.push_back(section);
-    }
-    return static_cast<Elf64_Half>(Sections.size());
+  // sets the associated sections
+  void setAssociatedSections(const std::vector<std::shared_ptr<Section>>& sections) {
+    Sections = sections;
   }
 
 }; // end of class SegmentImpl
@@ -414,14 +490,15 @@ template<class T>
 class SectionImpl : virtual public Section {
 
 protected:
-  /// The header of this section
+  /// The header of this section in host byte order
   T Header;
   /// The index of this section
   Elf64_Half Index;
   /// The name of this section
   std::string Name;
-  /// Data associated with this section
-  std::string Data;
+  /// Data associated with this section, fetched on first access. Copies of a
+  /// section share the same instance.
+  std::shared_ptr<LazyRange> Data;
   /// Pointer to an instance of \p EndianessConverter
   const std::shared_ptr<EndianessConverter> Converter;
 
@@ -445,7 +522,7 @@ public:
   /// Destructor of \p SectionImpl. Deletes all data read from the file
   /// associated with this section.
   virtual ~SectionImpl() {
-    Data.clear();
+    Data.reset();
   }
 
   Elf64_Half getIndex() const {
@@ -453,7 +530,7 @@ public:
   }
 
   Elf64_Word getType() const {
-    return (*Converter) (Header.sh_type);
+    return Header.sh_type;
   }
 
   const std::string getTypeString() const {
@@ -465,7 +542,7 @@ public:
   }
 
   Elf64_Xword getFlags() const {
-    return (*Converter) (Header.sh_flags);
+    return Header.sh_flags;
   }
 
   const std::string getFlagsString() const {
@@ -480,11 +557,13 @@ public:
   }
 
   const char* getData() const {
-    return Data.c_str();
+    const char* Result = getDataPointer();
+    return Result ? Result : "";
   }
 
   const std::string getDataString() const {
-    return Data;
+    const char* Result = getDataPointer();
+    return Result ? std::string(Result, getSize()) : std::string();
   }
 
   const std::string getName() const {
@@ -492,59 +571,59 @@ public:
   }
 
   Elf64_Word getInfo() const {
-    return (*Converter) (Header.sh_info);
+    return Header.sh_info;
   }
 
   Elf64_Word getLink() const {
-    return (*Converter) (Header.sh_link);
+    return Header.sh_link;
   }
 
   Elf64_Xword getAddressAlignment() const {
-    return (*Converter) (Header.sh_addralign);
+    return Header.sh_addralign;
   }
 
   Elf64_Xword getEntrySize() const {
-    return (*Converter) (Header.sh_entsize);
+    return Header.sh_entsize;
   }
 
   Elf64_Addr getAddress() const {
-    return (*Converter) (Header.sh_addr);
+    return Header.sh_addr;
   }
 
   Elf64_Off getOffset() const {
-    return (*Converter) (Header.sh_offset);
+    return Header.sh_offset;
   }
 
   Elf64_Xword getSize() const {
-    return (*Converter) (Header.sh_size);
+    return Header.sh_size;
   }
 
   Elf64_Word getNameStringOffset() const {
-    return (*Converter) (Header.sh_name);
+    return Header.sh_name;
+  }
+
+  /// Returns a pointer to the data of this section, fetching it if it has not
+  /// been accessed before.
+  ///
+  /// \return Pointer to the data or \p nullptr if the section has no data
+  const char* getDataPointer() const {
+    return Data ? Data->get() : nullptr;
   }
 
 protected:
-  /// Loads a section from a input stream at a specific stream offset.
+
+  /// Loads a section from an image at a specific offset.
   ///
-  /// \param stream The input stream to load from
-  /// \param offset The offset at which to load the section
-  void loadSection(std::ifstream& stream, std::streampos offset) {
+  /// \param source The image to load from
+  /// \param offset The offset of the section header in the image
+  void loadSection(const std::shared_ptr<ImageSource>& source, Elf64_Off offset) {
     std::fill_n(reinterpret_cast<char*>(&Header), sizeof(Header), '\0');
-    stream.seekg(offset);
-    stream.read(reinterpret_cast<char*>(&Header), sizeof(Header));
+    source->read(reinterpret_cast<char*>(&Header), offset, sizeof(Header));
+    convertSectionHeader(*Converter, Header);
 
     Elf64_Xword Size = getSize();
-    if (Data.empty() && getType() != SHT_NULL && getType() != SHT_NOBITS) {
-      try {
-        Data = std::string(Size, ' ');
-      } catch (const std::bad_alloc&) {
-        Data = "";
-        Size = 0;
-      }
-      if (!Data.empty()) {
-        stream.seekg((*Converter)(Header.sh_offset));
-        stream.read(&Data[0], Size);
-      }
+    if (!Data && Size != 0 && getType() != SHT_NULL && getType() != SHT_NOBITS) {
+      Data = std::make_shared<LazyRange>(source, getOffset(), Size);
     }
   }
 
@@ -569,19 +648,46 @@ protected:
 template <class T>
 class StringSectionImpl final : public SectionImpl<T>, virtual public StringSection {
 
+private:
+  /// A string found by \p scanStrings
+  struct ScannedString {
+    /// Length of the string
+    Elf64_Word Length;
+    /// Number of the string, equal strings have equal numbers
+    uint32_t Id;
+  };
+
+  /// Guards scanning the strings
+  mutable std::once_flag ScanDone;
+  /// \p true after the strings have been scanned
+  mutable std::atomic<bool> IsScanned;
+  /// Strings found by \p scanStrings by the index they start at
+  mutable std::unordered_map<Elf64_Word, ScannedString> Strings;
+
+  /// Returns the scanned string starting at \p index or \p nullptr.
+  const ScannedString* findScanned(const Elf64_Word index) const {
+    if (!IsScanned)
+      return nullptr;
+    auto Iter = Strings.find(index);
+    return Iter != Strings.end() ? &Iter->second : nullptr;
+  }
+
 public:
-  StringSectionImpl(const std::shared_ptr<EndianessConverter> converter) : SectionImpl<T>(converter) {}
+  StringSectionImpl(const std::shared_ptr<EndianessConverter> converter) :
+      SectionImpl<T>(converter), IsScanned(false), Strings() {}
 
   /// Copy constructor of \p StringSectionImpl.
   ///
   /// \param other The instance to copy
-  StringSectionImpl(const StringSectionImpl& other) : SectionImpl<T>(other) {}
+  StringSectionImpl(const StringSectionImpl& other) :
+      SectionImpl<T>(other), IsScanned(false), Strings() {}
 
   /// Constructor of \p StringSectionImpl. Constructs a new instance out of an
   /// existing instance of \p SectionImpl.
   ///
   /// \param other The base instance
-  StringSectionImpl(const SectionImpl<T>& other) : SectionImpl<T>(other) {}
+  StringSectionImpl(const SectionImpl<T>& other) :
+      SectionImpl<T>(other), IsScanned(false), Strings() {}
 
   // creates a new instance from a section pointer
   static const std::shared_ptr<StringSection> fromSection(const std::shared_ptr<Section>& base) {
@@ -601,12 +707,63 @@ public:
     // Invokes base class destructor, so nothing to do here.
   }
 
+  // returns the complete data of the string section
+  StringView getStringTable() const {
+    const char* Table = this->getDataPointer();
+    return Table ? StringView(Table, getSize()) : StringView();
+  }
+
+  // returns a view on a string of the string section
+  StringView getStringView(const Elf64_Word index) const {
+    StringView Table = getStringTable();
+    if (index >= Table.size()) {
+      return StringView();
+    }
+    const char* Begin = Table.data() + index;
+    if (auto Scanned = findScanned(index)) {
+      return StringView(Begin, Scanned->Length);
+    }
+    // the data is a view into the image, so it need not be null terminated
+    const void* End = std::memchr(Begin, '\0', Table.size() - index);
+    return StringView(Begin, End ? static_cast<const char*>(End) - Begin : Table.size() - index);
+  }
+
   // Gets a string from the string section
   const std::string getString(const Elf64_Word index) const {
-    if (index < getSize()) {
-      return std::string(getData() + index);
+    return getStringView(index).str();
+  }
+
+  // records start, length and number of every string
+  void scanStrings() const {
+    std::call_once(ScanDone, [this]() {
+      struct Hash {
+        std::size_t operator()(const StringView& name) const {
+          return SymbolNameIndex::hashName(name);
+        }
+      };
+      std::unordered_map<StringView, uint32_t, Hash> Ids;
+      StringView Table = getStringTable();
+      for (Elf64_Word Start = 0; Start < Table.size();) {
+        StringView String = getStringView(Start);
+        auto Id = Ids.emplace(String, static_cast<uint32_t>(Ids.size())).first->second;
+        Strings.emplace(Start, ScannedString{static_cast<Elf64_Word>(String.size()), Id});
+        Start += static_cast<Elf64_Word>(String.size()) + 1;
+      }
+      IsScanned = true;
+    });
+  }
+
+  // compares two strings of the string section
+  bool isSameString(const Elf64_Word lhs, const Elf64_Word rhs) const {
+    if (lhs == rhs) {
+      return true;
     }
-    return std::string();
+    auto Lhs = findScanned(lhs);
+    auto Rhs = findScanned(rhs);
+    if (Lhs && Rhs) {
+      return Lhs->Id == Rhs->Id;
+    }
+    return getStringView(lhs) == getStringView(rhs);
   }
 
 }; // end of class StringSectionImpl
@@ -616,6 +773,59 @@ public:
 template <class T, class U>
 class DynamicSectionImpl final : public SectionImpl<T>, virtual public DynamicSection {
 
+private:
+  /// The decoded entries and the index of the first entry of each tag
+  struct DecodedEntries final {
+    std::vector<DynamicSectionEntry> Entries;
+    std::unordered_map<Elf64_Xword, Elf64_Xword> FirstByTag;
+  };
+
+  /// Holds a pointer to the string section the entries refer to
+  std::shared_ptr<StringSection> StrSec;
+  /// Guards building \p Decoded
+  mutable std::once_flag DecodedBuilt;
+  /// The entries of this section, decoded on first use
+  mutable std::shared_ptr<const DecodedEntries> Decoded;
+
+  // decodes all entries on first use
+  const DecodedEntries& decoded() const {
+    std::call_once(DecodedBuilt, [this]() {
+      auto Result = std::make_shared<DecodedEntries>();
+      const char* Data = this->getDataPointer();
+      const Elf64_Xword Count = Data && getEntrySize() >= sizeof(U) ? getNumEntries() : 0;
+      Result->Entries.reserve(Count);
+
+      bool Terminated = false;
+      for (Elf64_Xword Index = 0; Index < Count; ++Index) {
+        DynamicEntryView<U, EndianessConverter> View(
+            reinterpret_cast<const U*>(Data + Index * getEntrySize()), *this->Converter);
+        DynamicSectionEntry Entry;
+        Entry.tag = static_cast<Elf64_Xword>(View.getTag());
+        switch (Entry.tag) {
+        case DT_NULL:
+        case DT_SYMBOLIC:
+        case DT_TEXTREL:
+        case DT_BIND_NOW:
+          // the value of these entries is ignored
+          Entry.value = 0;
+          break;
+        default:
+          Entry.value = View.getValue();
+          break;
+        }
+        Result->Entries.push_back(Entry);
+
+        // keeps the first entry of every tag
+        if (Entry.tag == DT_NULL)
+          Terminated = true;
+        else if (!Terminated)
+          Result->FirstByTag.emplace(Entry.tag, Index);
+      }
+      Decoded = Result;
+    });
+    return *Decoded;
+  }
+
 public:
   /// Constructor of \p DynamicSectionImpl.
   ///
@@ -625,17 +835,22 @@ public:
   /// Copy constructor of \p DynamicSectionImpl.
   ///
   /// \param other The instance to copy
-  DynamicSectionImpl(const DynamicSectionImpl& other) : SectionImpl<T>(other) {}
+  DynamicSectionImpl(const DynamicSectionImpl& other) : SectionImpl<T>(other),
+                                                        StrSec(other.StrSec),
+                                                        Decoded() {}
 
   /// Constructor of \p DynamicSectionImpl. Constructs a new instance out of an
-  /// existing instance of \p DynamicSectionImpl.
+  /// existing instance of \p DynamicSectionImpl and the string section the
+  /// entries refer to.
   ///
   /// \param other The base instance
-  DynamicSectionImpl(const SectionImpl<T>& other) : SectionImpl<T>(other) {}
+  /// \param str The string section linked to the dynamic section
+  DynamicSectionImpl(const SectionImpl<T>& other, const std::shared_ptr<StringSection>& str)
+      : SectionImpl<T>(other), StrSec(str), Decoded() {}
 
   /// Destructor of \p DynamicSectionImpl.
   virtual ~DynamicSectionImpl() {
-    // Invokes base class destructor, so nothing to do here.
+    StrSec.reset();
   }
 
   // returns number of entries
@@ -647,11 +862,14 @@ public:
   }
 
   // creates a new instance from a section pointer
-  static const std::shared_ptr<DynamicSection> fromSection(const std::shared_ptr<Section>& base) {
+  static const std::shared_ptr<DynamicSection> fromSection(
+      const std::shared_ptr<Section>& base,
+      const std::shared_ptr<StringSection>& str) {
     if (!base)
       return nullptr;
 
-    std::shared_ptr<DynamicSection> Result = std::make_shared<DynamicSectionImpl<T, U>>(*dynamic_cast<SectionImpl<T>*>(base.get()));
+    std::shared_ptr<DynamicSection> Result = std::make_shared<DynamicSectionImpl<T, U>>(
+        *dynamic_cast<SectionImpl<T>*>(base.get()), str);
 
     if (!Result) {
       return nullptr;
@@ -661,76 +879,33 @@ public:
 
   // return entry at index \p index
   const std::shared_ptr<DynamicSectionEntry> getEntry(const Elf64_Xword index) const {
-    if (index >= getNumEntries()) {
-      return nullptr;
-    }
-    auto Result = std::make_shared<DynamicSectionEntry>();
-    auto C = this->Converter;
-
-    if (!getData() || (index + 1) * getEntrySize() > getSize()) {
+    const auto& Entries = decoded().Entries;
+    if (index >= Entries.size()) {
       return nullptr;
     }
-
-    const U* pEntry = reinterpret_cast<const U*>(getData() + index * getEntrySize());
-    Result->tag = (*C) (pEntry->d_tag);
-
-    switch(Result->tag) {
-    case DT_NULL:
-    case DT_SYMBOLIC:
-    case DT_TEXTREL:
-    case DT_BIND_NOW:
-      Result->value = 0;
-      break;
-    case DT_NEEDED:
-    case DT_PLTRELSZ:
-    case DT_RELASZ:
-    case DT_RELAENT:
-    case DT_STRSZ:
-    case DT_SYMENT:
-    case DT_SONAME:
-    case DT_RPATH:
-    case DT_RELSZ:
-    case DT_RELENT:
-    case DT_PLTREL:
-    case DT_INIT_ARRAYSZ:
-    case DT_FINI_ARRAYSZ:
-    case DT_RUNPATH:
-    case DT_FLAGS:
-    case DT_PREINIT_ARRAYSZ:
-      Result->value = (*C) (pEntry->d_un.d_val);
-      break;
-    case DT_PLTGOT:
-    case DT_HASH:
-    case DT_STRTAB:
-    case DT_SYMTAB:
-    case DT_RELA:
-    case DT_INIT:
-    case DT_FINI:
-    case DT_REL:
-    case DT_DEBUG:
-    case DT_JMPREL:
-    case DT_INIT_ARRAY:
-    case DT_FINI_ARRAY:
-    case DT_PREINIT_ARRAY:
-    default:
-      Result->value = (*C) (pEntry->d_un.d_ptr);
-      break;
-    }
-    return Result;
+    return std::make_shared<DynamicSectionEntry>(Entries[index]);
   }
 
   // return all entries
   const std::vector<DynamicSectionEntry> getAllEntries() const {
-    std::shared_ptr<DynamicSectionEntry> Entry {nullptr};
-    std::vector<DynamicSectionEntry> Result {};
+    return decoded().Entries;
+  }
 
-    for (Elf64_Xword iter = 0; iter < getNumEntries(); ++iter) {
-      Entry = getEntry(iter);
-      if (Entry) {
-        Result.push_back(*Entry);
-      }
-    }
-    return Result;
+  // return all entries without copying
+  const std::vector<DynamicSectionEntry>& entries() const {
+    return decoded().Entries;
+  }
+
+  // return the first entry with a tag
+  const DynamicSectionEntry* findEntry(const Elf64_Xword tag) const {
+    const auto& Decoded = decoded();
+    auto Iter = Decoded.FirstByTag.find(tag);
+    return Iter != Decoded.FirstByTag.end() ? &Decoded.Entries[Iter->second] : nullptr;
+  }
+
+  // returns the associated string section
+  const std::shared_ptr<StringSection> getStringSection() const {
+    return StrSec;
   }
 
 }; // end of class DynamicSectionImpl
@@ -743,6 +918,10 @@ class SymbolSectionImpl : public SectionImpl<T>, virtual public SymbolSection {
 private:
   /// Holds a pointer to the associated string section
   std::shared_ptr<StringSection> StrSec;
+  /// Guards building \p Resolved
+  mutable std::once_flag ResolvedBuilt;
+  /// All symbols of this section, built on first use
+  mutable std::shared_ptr<const std::vector<SymbolRef>> Resolved;
 
 public:
   /// Constructor of \p SymbolSectionImpl.
@@ -756,14 +935,15 @@ public:
   ///
   /// \param other The instance to copy
   SymbolSectionImpl(const SymbolSectionImpl& other) : SectionImpl<T>(other),
-                                                      StrSec(other.StrSec) {}
+                                                      StrSec(other.StrSec),
+                                                      Resolved() {}
 
   /// Constructor of \p SymbolSectionImpl. Constructs a new instance out of an
   /// existing instance of \p SymbolSectionImpl and an intance of \p StringSection.
   ///
   /// \param other The base instance
   SymbolSectionImpl(const SectionImpl<T>& other, const std::shared_ptr<StringSection>& str)
-      : SectionImpl<T>(other), StrSec(str) {}
+      : SectionImpl<T>(other), StrSec(str), Resolved() {}
 
   /// Destructor of \p SymbolSectionImpl.
   virtual ~SymbolSectionImpl() {
@@ -809,22 +989,69 @@ public:
     return Result;
   }
 
+  // returns a range over all symbols
+  SymbolRange symbols() const {
+    return SymbolRange(this->getDataPointer(), getSize(), getEntrySize(),
+                       std::is_same<U, Elf64_Sym>::value, *this->Converter,
+                       StrSec ? StrSec->getStringTable() : StringView());
+  }
+
+  // returns the associated string section
+  const std::shared_ptr<StringSection> getStringSection() const {
+    return StrSec;
+  }
+
+  // decodes consecutive symbols
+  Elf64_Xword decodeSymbols(Elf64_Xword first, Elf64_Xword count, SymbolRef* symbols) const {
+    const auto Range = this->symbols();
+    if (first >= Range.size()) {
+      return 0;
+    }
+    count = std::min(count, Range.size() - first);
+    for (Elf64_Xword iter = 0; iter < count; ++iter) {
+      symbols[iter] = Range[first + iter];
+    }
+    return count;
+  }
+
+  // decodes all symbols in chunks on several threads
+  const std::vector<SymbolRef> decodeAllSymbols(unsigned int threads) const {
+    std::vector<SymbolRef> Result(symbols().size());
+    decodeInChunks(Result.size(), threads, [this, &Result](Elf64_Xword first, Elf64_Xword count) {
+      decodeSymbols(first, count, Result.data() + first);
+    });
+    return Result;
+  }
+
+  // returns all symbols, decoding them on the first call
+  const std::shared_ptr<const std::vector<SymbolRef>> getResolvedSymbols() const {
+    std::call_once(ResolvedBuilt, [this]() {
+      auto Range = symbols();
+      auto Table = std::make_shared<std::vector<SymbolRef>>();
+      Table->reserve(Range.size());
+      for (auto Symbol : Range) {
+        Table->push_back(Symbol);
+      }
+      Resolved = Table;
+    });
+    return Resolved;
+  }
+
   const std::shared_ptr<Symbol> getSymbol(const Elf64_Xword index) const {
-    if (index >= getNumSymbols()) {
+    if (!this->getDataPointer() || index >= getNumSymbols()) {
       return nullptr;
     }
+    SymbolView<U, EndianessConverter> Sym(
+        reinterpret_cast<const U*>(getData() + index * getEntrySize()), *this->Converter);
     std::shared_ptr<Symbol> Result = std::make_shared<Symbol>();
 
-    auto C = this->Converter;
-    const U* pSym = reinterpret_cast<const U*>(getData() + index * getEntrySize());
-
-    Result->name = StrSec->getString((*C) (pSym->st_name));
-    Result->value = (*C) (pSym->st_value);
-    Result->size = (*C) (pSym->st_size);
-    Result->bind = ELF64_ST_BIND(pSym->st_info);  // is the same as ELF32_ST_BIND
-    Result->type = ELF64_ST_TYPE(pSym->st_info);  // is the same as ELF32_ST_TYPE
-    Result->sectionIndex = (*C) (pSym->st_shndx);
-    Result->other = pSym->st_other;
+    Result->name = StrSec->getString(Sym.getNameOffset());
+    Result->value = Sym.getValue();
+    Result->size = Sym.getSize();
+    Result->bind = Sym.getBind();
+    Result->type = Sym.getType();
+    Result->sectionIndex = Sym.getSectionIndex();
+    Result->other = Sym.getOther();
 
     return Result;
   }
@@ -902,97 +1129,240 @@ public:
     return 0;
   }
 
-  // return all entries
+  // returns the associated symbol section
+  const std::shared_ptr<SymbolSection> getSymbolSection() const {
+    return Symbols;
+  }
+
+  // return all entries, decoding every symbol only once
   const std::vector<std::shared_ptr<RelocationEntry>> getAllEntries() const {
-    std::shared_ptr<RelocationEntry> Entry {nullptr};
+    const auto Records = getAllRecords();
     std::vector<std::shared_ptr<RelocationEntry>> Result {};
-
-    for (Elf64_Xword iter = 0; iter < getNumEntries(); ++iter) {
-      Entry = getEntry(iter);
-      if (Entry) {
-        Result.push_back(Entry);
+    Result.reserve(Records.size());
+
+    std::unordered_map<Elf64_Word, std::shared_ptr<Symbol>> SymbolInstances;
+    for (const auto& Record : Records) {
+      auto Instance = SymbolInstances.find(Record.SymbolIndex);
+      if (Instance == SymbolInstances.end()) {
+        Instance = SymbolInstances.emplace(Record.SymbolIndex,
+                                           Symbols->getSymbol(Record.SymbolIndex)).first;
       }
+      Result.push_back(makeEntry(Record, Instance->second));
     }
     return Result;
   }
 
-
-  /// Generically returns an entry without addend from the underlying relocation
-  /// section. The entry is specified by \p index.
+  /// Generically decodes consecutive entries of the underlying relocation
+  /// section. The entries must exist.
   ///
-  /// \tparam T Type of the entry
-  /// \param index Index of the entry in the relocation section
-  /// \return Entry of the relocation section
+  /// \tparam U Type of the entries
+  /// \param first Index of the first entry in the relocation section
+  /// \param count Number of entries to decode
+  /// \param records Buffer for the decoded entries
   template <typename U>
-  const std::shared_ptr<RelocationEntry> getEntryRel(const Elf64_Xword index) const {
-    const U* pEntry = reinterpret_cast<const U*>(getData() + index * getEntrySize());
-    std::shared_ptr<RelocationEntry> Result = std::make_shared<RelocationEntry>();
-    auto C = this->Converter;
+  void decodeRecordsOfType(Elf64_Xword first, Elf64_Xword count,
+                           RelocationRecord* records) const {
+    const char* Entries = getData() + first * getEntrySize();
+    for (Elf64_Xword iter = 0; iter < count; ++iter) {
+      RelocationView<U, EndianessConverter> Entry(
+          reinterpret_cast<const U*>(Entries + iter * getEntrySize()), *this->Converter);
+      records[iter] = {Entry.getOffset(), Entry.getInfo(), Entry.getAddend(),
+                       Entry.getSymbolIndex(), Entry.getType()};
+    }
+  }
+
+  // decodes consecutive entries
+  Elf64_Xword decodeRecords(Elf64_Xword first, Elf64_Xword count,
+                            RelocationRecord* records) const {
+    if (!this->getDataPointer() || first >= getNumEntries()) {
+      return 0;
+    }
+    count = std::min(count, getNumEntries() - first);
+
+    switch (getType()) {
+    case SHT_REL:
+      if (is64Bit) {
+        decodeRecordsOfType<Elf64_Rel>(first, count, records);
+      } else {
+        decodeRecordsOfType<Elf32_Rel>(first, count, records);
+      }
+      return count;
+    case SHT_RELA:
+      if (is64Bit) {
+        decodeRecordsOfType<Elf64_Rela>(first, count, records);
+      } else {
+        decodeRecordsOfType<Elf32_Rela>(first, count, records);
+      }
+      return count;
+    default:
+      return 0;
+    }
+  }
 
-    Result->Offset = (*C) (pEntry->r_offset);
-    Result->Info = (*C) (pEntry->r_info);
-    Result->SymbolIndex = getSymbolAndType<U>::getSym(Result->Info);
-    Result->Type = getSymbolAndType<U>::getType(Result->Info);
-    Result->Addend = 0;
+  // decodes all entries
+  const std::vector<RelocationRecord> getAllRecords() const {
+    std::vector<RelocationRecord> Result(getNumEntries());
+    Result.resize(decodeRecords(0, Result.size(), Result.data()));
     return Result;
   }
 
-  /// Generically returns an entry with addend from the underlying relocation
-  /// section. The entry is specified by \p index.
+  // decodes all entries in chunks on several threads
+  const std::vector<RelocationRecord> decodeAllRecords(unsigned int threads) const {
+    if (!this->getDataPointer() || (getType() != SHT_REL && getType() != SHT_RELA)) {
+      return {};
+    }
+    std::vector<RelocationRecord> Result(getNumEntries());
+    decodeInChunks(Result.size(), threads, [this, &Result](Elf64_Xword first, Elf64_Xword count) {
+      decodeRecords(first, count, Result.data() + first);
+    });
+    return Result;
+  }
+
+  /// Creates an entry out of a decoded record.
   ///
-  /// \tparam T Type of the entry
-  /// \param index Index of the entry in the relocation section
+  /// \param record The decoded record
+  /// \param symbol The symbol of the record
   /// \return Entry of the relocation section
-  template <typename U>
-  const std::shared_ptr<RelocationEntry> getEntryRela(const Elf64_Xword index) const {
-    const U* pEntry = reinterpret_cast<const U*>(getData() + index * getEntrySize());
+  static std::shared_ptr<RelocationEntry> makeEntry(const RelocationRecord& record,
+                                                    const std::shared_ptr<Symbol>& symbol) {
     std::shared_ptr<RelocationEntry> Result = std::make_shared<RelocationEntry>();
-    auto C = this->Converter;
-
-    Result->Offset = (*C) (pEntry->r_offset);
-    Result->Info = (*C) (pEntry->r_info);
-    Result->SymbolIndex = getSymbolAndType<U>::getSym(Result->Info);
-    Result->Type = getSymbolAndType<U>::getType(Result->Info);
-    Result->Addend = (*C) (pEntry->r_addend);
+    Result->Offset = record.Offset;
+    Result->Info = record.Info;
+    Result->SymbolIndex = record.SymbolIndex;
+    Result->Type = record.Type;
+    Result->Addend = record.Addend;
+    Result->SymbolInstance = symbol;
     return Result;
   }
 
   // returns single entry from relocation section
   const std::shared_ptr<RelocationEntry> getEntry(const Elf64_Xword index) const {
-    if (index >= getNumEntries()) {
+    RelocationRecord Record;
+    if (decodeRecords(index, 1, &Record) != 1) {
       return nullptr;
     }
+    return makeEntry(Record, Symbols->getSymbol(Record.SymbolIndex));
+  }
 
-    std::shared_ptr<RelocationEntry> Result;
-    if (is64Bit) {
-      switch (getType()) {
-      case SHT_REL:
-        Result =  getEntryRel<Elf64_Rel>(index);
-        break;
-      case SHT_RELA:
-        Result = getEntryRela<Elf64_Rela>(index);
-        break;
-      default:
-        return nullptr;
-      }
-    } else {
-      switch (getType()) {
-      case SHT_REL:
-        Result = getEntryRel<Elf32_Rel>(index);
-        break;
-      case SHT_RELA:
-        Result = getEntryRela <Elf32_Rela>(index);
-        break;
-      default:
-        return nullptr;
-      }
+}; // end of class RelocationSectionImpl
+
+
+/// Template implementation of \p RelrSection
+template <class T>
+class RelrSectionImpl final : public SectionImpl<T>, virtual public RelrSection {
+
+private:
+  /// Type of relative relocations on the file's machine
+  const Elf64_Word RelativeType;
+  /// Guards expanding \p Offsets
+  mutable std::once_flag OffsetsExpanded;
+  /// The offsets of all relocations, expanded on first indexed access
+  mutable std::vector<Elf64_Addr> Offsets;
+  /// Symbol of all entries, as relative relocations have none
+  const std::shared_ptr<Symbol> NoSymbol;
+
+  /// Returns the offsets of all relocations.
+  const std::vector<Elf64_Addr>& getOffsets() const {
+    std::call_once(OffsetsExpanded, [this]() {
+      auto Range = offsets();
+      Offsets.resize(Range.count());
+      Offsets.resize(Range.expand(Offsets.data(), Offsets.size()));
+    });
+    return Offsets;
+  }
+
+public:
+  /// Constructor of \p RelrSectionImpl. Constructs a new instance out of an
+  /// existing instance of \p SectionImpl.
+  ///
+  /// \param other The base instance
+  /// \param relativeType Type of relative relocations on the file's machine
+  RelrSectionImpl(const SectionImpl<T>& other, Elf64_Word relativeType) :
+      SectionImpl<T>(other), RelativeType(relativeType), Offsets(),
+      NoSymbol(std::make_shared<Symbol>()) {}
+
+  /// Destructor of \p RelrSectionImpl.
+  virtual ~RelrSectionImpl() {
+    // Invokes base class destructor, so nothing to do here.
+  }
+
+  // creates a new instance from a section pointer
+  static const std::shared_ptr<RelocationSection> fromSection(
+      const std::shared_ptr<Section>& base, unsigned int machine) {
+    if (!base)
+      return nullptr;
+
+    auto Type = RelativeRelocationTypes.find(machine);
+    return std::make_shared<RelrSectionImpl<T>>(
+        *dynamic_cast<SectionImpl<T>*>(base.get()),
+        Type != RelativeRelocationTypes.end() ? Type->second : 0);
+  }
+
+  // returns a range over the offsets
+  RelrRange offsets() const {
+    // the entry size is the word size, even if sh_entsize is not set
+    return RelrRange(this->getDataPointer(), getSize(),
+                     std::is_same<T, Elf64_Shdr>::value ? 8 : 4, *this->Converter);
+  }
+
+  // returns number of entries
+  const Elf64_Xword getNumEntries() const {
+    return getOffsets().size();
+  }
+
+  // relative relocations have no symbols
+  const std::shared_ptr<SymbolSection> getSymbolSection() const {
+    return nullptr;
+  }
+
+  // decodes consecutive entries
+  Elf64_Xword decodeRecords(Elf64_Xword first, Elf64_Xword count,
+                            RelocationRecord* records) const {
+    const auto& All = getOffsets();
+    if (first >= All.size()) {
+      return 0;
+    }
+    count = std::min(count, All.size() - first);
+    const Elf64_Xword Info = std::is_same<T, Elf64_Shdr>::value ?
+        ELF64_R_INFO(0, RelativeType) : ELF32_R_INFO(0, RelativeType);
+    for (Elf64_Xword iter = 0; iter < count; ++iter) {
+      records[iter] = {All[first + iter], Info, 0, 0, RelativeType};
     }
+    return count;
+  }
 
-    Result->SymbolInstance = Symbols->getSymbol(Result->SymbolIndex);
+  // decodes all entries
+  const std::vector<RelocationRecord> getAllRecords() const {
+    std::vector<RelocationRecord> Result(getNumEntries());
+    Result.resize(decodeRecords(0, Result.size(), Result.data()));
     return Result;
   }
 
-}; // end of class RelocationSectionImpl
+  // packed relocations are expanded sequentially, so there is nothing to
+  // split into chunks
+  const std::vector<RelocationRecord> decodeAllRecords(unsigned int) const {
+    return getAllRecords();
+  }
+
+  // returns single entry
+  const std::shared_ptr<RelocationEntry> getEntry(const Elf64_Xword index) const {
+    RelocationRecord Record;
+    if (decodeRecords(index, 1, &Record) != 1) {
+      return nullptr;
+    }
+    return RelocationSectionImpl<T>::makeEntry(Record, NoSymbol);
+  }
+
+  // return all entries
+  const std::vector<std::shared_ptr<RelocationEntry>> getAllEntries() const {
+    std::vector<std::shared_ptr<RelocationEntry>> Result {};
+    for (const auto& Record : getAllRecords()) {
+      Result.push_back(RelocationSectionImpl<T>::makeEntry(Record, NoSymbol));
+    }
+    return Result;
+  }
+
+}; // end of class RelrSectionImpl
 
 
 /// Template implementation of \p NoteSectionImpl
@@ -1000,12 +1370,14 @@ template <class T>
 class NoteSectionImpl : public SectionImpl<T>, virtual public NoteSection {
 
 private:
-  /// Holds all note section entries (filled at creation of section)
-  std::vector<std::shared_ptr<Note>> Notes;
+  /// Holds all note section entries (filled on first access)
+  mutable std::vector<std::shared_ptr<Note>> Notes;
+  /// Guards the one-time parsing of the notes
+  mutable std::once_flag NotesLoaded;
 
 
-  /// Loads all notes from the section. Should be called at creation of object.
-  void loadNotes() {
+  /// Loads all notes from the section. Called once on first access.
+  void loadNotes() const {
     Notes.clear();
 
     const char* Data = getData();
@@ -1013,7 +1385,7 @@ private:
     Elf64_Xword Current = 0;
 
     // Early-return if no data present
-    if (!Data ||!Size) {
+    if (!this->getDataPointer() || !Size) {
       return;
     }
 
@@ -1026,24 +1398,24 @@ private:
       namesz = (*C) (*reinterpret_cast<const Elf64_Word*>(Data + Current));
       descsz = (*C) (*reinterpret_cast<const Elf64_Word*>(Data + Current + sizeof(namesz)));
 
-      std::string Name = "";
-      const char* Desc = 0;
+      // name and description must lie within the section, the image may come
+      // from an untrusted buffer
+      Elf64_Xword NameOffset = Current + 3 * align;
+      Elf64_Xword DescOffset = NameOffset + ((Elf64_Xword(namesz) + align - 1) / align) * align;
+      Elf64_Xword Next = DescOffset + ((Elf64_Xword(descsz) + align - 1) / align) * align;
+      if (DescOffset > Size || descsz > Size - DescOffset) {
+        break;
+      }
 
+      entry = std::make_shared<Note>();
       if (namesz)
-        Name.assign(Data + 3 * align, namesz - 1);
-
+        entry->Name.assign(Data + NameOffset, namesz - 1);
       if (descsz)
-        Desc = (Data + 3 * align + ((namesz + align - 1) / align) * align);
-
-      entry = std::make_shared<Note>();
-      entry->Name = Name;
-      entry->Description = std::string(Desc, descsz);
-      entry->Type = (*C) (*reinterpret_cast<const Elf64_Word*>(Data + 2 * align));
+        entry->Description.assign(Data + DescOffset, descsz);
+      entry->Type = (*C) (*reinterpret_cast<const Elf64_Word*>(Data + Current + 2 * align));
       Notes.push_back(entry);
 
-      Current += 3 * align +
-          ((namesz + align - 1) / align) * align +
-          ((descsz + align - 1) / align) * align;
+      Current = Next;
     }
   }
 
@@ -1052,26 +1424,20 @@ public:
   ///
   /// \param converter Pointer to an endianess converter
   NoteSectionImpl(const std::shared_ptr<EndianessConverter> converter) :
-      SectionImpl<T>(converter), Notes() {
-
-    loadNotes();
-  }
+      SectionImpl<T>(converter), Notes() {}
 
   /// Copy constructor of \p NoteSectionImpl.
   ///
   /// \param other The instance to copy
   NoteSectionImpl(const NoteSectionImpl& other) : SectionImpl<T>(other),
-                                                  Notes(other.Notes) {}
+                                                  Notes() {}
 
   /// Constructor of \p NoteSectionImpl. Constructs a new instance out of
   /// an existing instance of \p NoteSectionImpl.
   ///
   /// \param other The base instance
   NoteSectionImpl(const SectionImpl<T>& other) : SectionImpl<T>(other),
-                                                 Notes() {
-
-    loadNotes();
-  }
+                                                 Notes() {}
 
   /// Destructor of \p NoteSectionImpl.
   virtual ~NoteSectionImpl() {
@@ -1092,26 +1458,103 @@ public:
     return Result;
   }
 
+  /// Returns all notes of the section, parsing them on the first call.
+  ///
+  /// \return Reference to the vector of notes
+  const std::vector<std::shared_ptr<Note>>& getNotes() const {
+    std::call_once(NotesLoaded, &NoteSectionImpl::loadNotes, this);
+    return Notes;
+  }
+
   // returns number of entries
   const Elf64_Xword getNumEntries() const {
-    return Notes.size();
+    return getNotes().size();
   }
 
   // return entry
   const std::shared_ptr<Note> getEntry(const Elf64_Xword index) const {
-    if (index >= Notes.size()) {
+    if (index >= getNotes().size()) {
       return nullptr;
     }
-    return Notes[index];
+    return getNotes()[index];
   }
 
   // return all entries
   const std::vector<std::shared_ptr<Note>> getAllEntries() const {
-    return Notes;
+    return getNotes();
   }
 
 }; // end of class NoteSectionImpl
 
+
+/// Indexes of an \p ELFFile that are built on first use. Copies of a file
+/// share the same instance, so every index is built only once.
+struct FileIndexes final {
+  /// Hashes section names for \p SectionsByName
+  struct NameHash final {
+    std::size_t operator()(const StringView& name) const {
+      return SymbolNameIndex::hashName(name);
+    }
+  };
+
+  /// Sections by name, the names are views into the section name table
+  std::unordered_map<StringView, std::vector<std::shared_ptr<Section>>, NameHash> SectionsByName;
+  /// Sections by type
+  std::unordered_map<Elf64_Word, std::vector<std::shared_ptr<Section>>> SectionsByType;
+  /// Layout of sections and segments, built while loading
+  std::shared_ptr<const FileLayoutIndex> Layout;
+  /// Copy of a range of the memory image of a segment, i.e. its file data
+  /// followed by zeros
+  struct MemoryWindow final {
+    /// Offset of the first byte from the start of the segment
+    Elf64_Xword Start;
+    /// Number of bytes
+    Elf64_Xword Size;
+    /// The bytes, allocated with \p calloc
+    std::unique_ptr<char, void (*)(void*)> Memory;
+  };
+
+  /// Windows handed out for the zero-filled tail of a segment. They are
+  /// never changed and kept as long as the file, as their bytes may be in
+  /// use.
+  struct SegmentWindows final {
+    /// Guards creating windows
+    std::mutex Lock;
+    /// The largest window, read without locking
+    std::atomic<const MemoryWindow*> Current;
+    /// All windows created so far
+    std::vector<std::unique_ptr<MemoryWindow>> Windows;
+
+    SegmentWindows() : Lock(), Current(nullptr), Windows() {}
+  };
+
+  /// Windows for ranges reaching from the file data into the zero-filled
+  /// tail, by segment index
+  std::unique_ptr<SegmentWindows[]> SegmentTails;
+  /// Zeros for ranges entirely within the zero-filled tail of any segment
+  SegmentWindows Zeros;
+  /// Guards building \p AddressIndex
+  std::once_flag AddressIndexBuilt;
+  /// Index for looking up symbols by address
+  std::shared_ptr<const SymbolAddressIndex> AddressIndex;
+  /// Guards building \p NameIndex
+  std::once_flag NameIndexBuilt;
+  /// Index for looking up symbols by name
+  std::shared_ptr<const SymbolNameIndex> NameIndex;
+  /// Guards building \p HashTable
+  std::once_flag HashTableBuilt;
+  /// Lookup of dynamic symbols through the file's hash table
+  std::shared_ptr<const SymbolHashTable> HashTable;
+  /// Guards building \p VersionTable
+  std::once_flag VersionTableBuilt;
+  /// Symbol versions of the dynamic symbols
+  std::shared_ptr<const SymbolVersionTable> VersionTable;
+  /// Guards building \p NeededLibraries
+  std::once_flag NeededLibrariesBuilt;
+  /// Names of the libraries in the \p DT_NEEDED entries
+  std::vector<std::string> NeededLibraries;
+};
+
 } // end of namespace libelfpp
 
 #endif //LIBELFPP_PRIVATE_IMPL_H
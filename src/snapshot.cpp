@@ -0,0 +1,500 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+/**
+ * \file        snapshot.cpp
+ * \brief       Source file implementing on-disk snapshots of the metadata of
+ *              ELF files
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p MetadataSnapshot.
+ */
+
+#include "libelfpp/snapshot.h"
+#include "imagesource.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace libelfpp {
+
+const Elf64_Word MetadataSnapshot::FormatVersion;
+
+static_assert(sizeof(SnapshotFileInfo) == 24, "unexpected layout of SnapshotFileInfo");
+static_assert(sizeof(SnapshotSection) == 72, "unexpected layout of SnapshotSection");
+static_assert(sizeof(SnapshotSegment) == 64, "unexpected layout of SnapshotSegment");
+static_assert(sizeof(SnapshotSymbol) == 40, "unexpected layout of SnapshotSymbol");
+static_assert(sizeof(SnapshotDynamicEntry) == 24, "unexpected layout of SnapshotDynamicEntry");
+static_assert(sizeof(SnapshotNameSlot) == 8, "unexpected layout of SnapshotNameSlot");
+
+/// Magic bytes at the start of every snapshot
+static const char SnapshotMagic[8] = {'E', 'L', 'F', 'P', 'P', 'S', 'N', 'P'};
+
+/// Written as is, reads differently on hosts with another byte order
+static const Elf64_Word SnapshotByteOrder = 0x01020304;
+
+/// Tables of a snapshot in the order they are stored
+enum SnapshotTableIndex {
+  SectionTable,
+  SegmentTable,
+  SegmentSectionTable,
+  SymbolTable,
+  EnclosingTable,
+  NameSlotTable,
+  DynamicTable,
+  StringTable,
+  BuildIdTable,
+  TableCount
+};
+
+/// Location of a table in a snapshot
+struct SnapshotTable {
+  /// Offset of the first record, a multiple of 8
+  Elf64_Off Offset;
+  /// Number of records
+  Elf64_Xword Count;
+};
+
+/// Header at the start of every snapshot
+struct SnapshotHeader {
+  /// Must be \p SnapshotMagic
+  char Magic[8];
+  /// Version of the format
+  Elf64_Word Version;
+  /// Must be \p SnapshotByteOrder
+  Elf64_Word ByteOrder;
+  /// Size of the snapshot in bytes
+  Elf64_Xword TotalSize;
+  /// Identity of the ELF file the snapshot was taken from
+  Elf64_Xword Device;
+  Elf64_Xword Inode;
+  Elf64_Sxword ModificationTime;
+  Elf64_Xword Size;
+  /// The file header
+  SnapshotFileInfo Info;
+  /// The tables
+  SnapshotTable Tables[TableCount];
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "unexpected layout of SnapshotHeader");
+
+/// Tables are aligned to the largest alignment of their records
+static const Elf64_Xword TableAlignment = 8;
+
+/// Appends a string to the strings of a snapshot.
+///
+/// \param strings The strings of the snapshot
+/// \param str The string to append
+/// \param offset Receives the offset of the string
+/// \param length Receives the length of the string
+static void addString(std::string& strings, const StringView& str,
+                      Elf64_Word& offset, Elf64_Word& length) {
+  if (strings.size() + str.size() > 0xFFFFFFFFu) {
+    throw std::runtime_error("Too many names for a snapshot!");
+  }
+  offset = static_cast<Elf64_Word>(strings.size());
+  length = static_cast<Elf64_Word>(str.size());
+  strings.append(str.data(), str.size());
+}
+
+/// Appends the records of a table to the contents of a snapshot.
+///
+/// \param contents The contents of the snapshot
+/// \param table Receives the location of the table
+/// \param records The records of the table
+/// \param count Number of records
+/// \param recordSize Size of a record
+static void addTable(std::string& contents, SnapshotTable& table,
+                     const void* records, Elf64_Xword count, Elf64_Xword recordSize) {
+  contents.resize((contents.size() + TableAlignment - 1) / TableAlignment * TableAlignment);
+  table.Offset = contents.size();
+  table.Count = count;
+  contents.append(static_cast<const char*>(records), count * recordSize);
+}
+
+/// Appends a table of records to the contents of a snapshot.
+template <typename T>
+static void addTable(std::string& contents, SnapshotTable& table, const std::vector<T>& records) {
+  static_assert(std::is_trivially_copyable<T>::value, "records must be trivially copyable");
+  addTable(contents, table, records.data(), records.size(), sizeof(T));
+}
+
+/// Returns the records of a table of a mapped snapshot.
+///
+/// \param data The mapped snapshot
+/// \param size Size of the snapshot
+/// \param table The location of the table
+/// \param result Receives the records
+/// \return \p false if the table does not lie within the snapshot
+template <typename T>
+static bool getTable(const char* data, Elf64_Xword size, const SnapshotTable& table,
+                     SnapshotArray<T>& result) {
+  if (table.Offset % TableAlignment != 0 || table.Offset > size ||
+      table.Count > (size - table.Offset) / sizeof(T))
+    return false;
+  result = SnapshotArray<T>(reinterpret_cast<const T*>(data + table.Offset), table.Count);
+  return true;
+}
+
+// Writes a snapshot of a file
+bool MetadataSnapshot::write(const ELFFile& file, const FileIdentity& source,
+                             const std::string& path) {
+  const auto FileHeader = file.getHeader();
+
+  SnapshotHeader Header;
+  std::memset(&Header, 0, sizeof(Header));
+  std::memcpy(Header.Magic, SnapshotMagic, sizeof(SnapshotMagic));
+  Header.Version = FormatVersion;
+  Header.ByteOrder = SnapshotByteOrder;
+  Header.Device = source.Device;
+  Header.Inode = source.Inode;
+  Header.ModificationTime = source.ModificationTime;
+  Header.Size = source.Size;
+  Header.Info.EntryPoint = FileHeader->getEntryPoint();
+  Header.Info.Version = FileHeader->getVersion();
+  Header.Info.Flags = FileHeader->getFlags();
+  Header.Info.Type = static_cast<Elf64_Half>(FileHeader->getELFType());
+  Header.Info.Machine = static_cast<Elf64_Half>(FileHeader->getMachine());
+  Header.Info.Is64Bit = FileHeader->is64Bit() ? 1 : 0;
+  Header.Info.IsLittleEndian = FileHeader->isLittleEndian() ? 1 : 0;
+  Header.Info.ABI = static_cast<unsigned char>(FileHeader->getABI());
+
+  std::string Strings;
+
+  std::vector<SnapshotSection> Sections;
+  Sections.reserve(file.sections().size());
+  for (const auto& Sec : file.sections()) {
+    SnapshotSection Record;
+    std::memset(&Record, 0, sizeof(Record));
+    Record.Flags = Sec->getFlags();
+    Record.Address = Sec->getAddress();
+    Record.Offset = Sec->getOffset();
+    Record.Size = Sec->getSize();
+    Record.AddressAlignment = Sec->getAddressAlignment();
+    Record.EntrySize = Sec->getEntrySize();
+    Record.Type = Sec->getType();
+    Record.Link = Sec->getLink();
+    Record.Info = Sec->getInfo();
+    addString(Strings, Sec->getName(), Record.NameOffset, Record.NameLength);
+    Sections.push_back(Record);
+  }
+
+  std::vector<SnapshotSegment> Segments;
+  std::vector<Elf64_Word> SegmentSections;
+  Segments.reserve(file.segments().size());
+  for (const auto& Seg : file.segments()) {
+    SnapshotSegment Record;
+    Record.Offset = Seg->getOffset();
+    Record.VirtualAddress = Seg->getVirtualAddress();
+    Record.PhysicalAddress = Seg->getPhysicalAddress();
+    Record.FileSize = Seg->getFileSize();
+    Record.MemorySize = Seg->getMemorySize();
+    Record.AddressAlignment = Seg->getAddressAlignment();
+    Record.Type = Seg->getType();
+    Record.Flags = Seg->getFlags();
+    Record.FirstSection = static_cast<Elf64_Word>(SegmentSections.size());
+    for (const auto& Sec : Seg->getAssociatedSections()) {
+      SegmentSections.push_back(Sec->getIndex());
+    }
+    Record.SectionCount = static_cast<Elf64_Word>(SegmentSections.size()) - Record.FirstSection;
+    Segments.push_back(Record);
+  }
+
+  // the symbols are stored sorted by address, so the snapshot answers
+  // address lookups without building an index
+  const auto& Entries = file.getAddressIndex()->getEntries();
+  if (Entries.size() >= 0x7FFFFFFFu) {
+    throw std::runtime_error("Too many symbols for a snapshot!");
+  }
+  std::vector<SnapshotSymbol> Symbols;
+  Symbols.reserve(Entries.size());
+  for (const auto& Entry : Entries) {
+    SnapshotSymbol Record;
+    std::memset(&Record, 0, sizeof(Record));
+    Record.Value = Entry.Symbol.value;
+    Record.Size = Entry.Symbol.size;
+    Record.SymbolIndex = Entry.SymbolIndex;
+    addString(Strings, Entry.Symbol.name, Record.NameOffset, Record.NameLength);
+    Record.SectionIndex = Entry.Symbol.sectionIndex;
+    Record.SymbolSectionIndex = Entry.SymbolSectionIndex;
+    Record.Bind = Entry.Symbol.bind;
+    Record.Type = Entry.Symbol.type;
+    Record.Other = Entry.Symbol.other;
+    Symbols.push_back(Record);
+  }
+  std::vector<Elf64_Word> EnclosingSymbols(file.getAddressIndex()->getEnclosing().begin(),
+                                           file.getAddressIndex()->getEnclosing().end());
+
+  // open addressing with linear probing, at most half of the slots are used
+  Elf64_Word Capacity = 1;
+  while (Capacity < 2 * Symbols.size())
+    Capacity *= 2;
+  std::vector<SnapshotNameSlot> NameSlots(Capacity, SnapshotNameSlot{0, 0});
+  for (Elf64_Word Index = 0; Index < Symbols.size(); ++Index) {
+    StringView Name(Strings.data() + Symbols[Index].NameOffset, Symbols[Index].NameLength);
+    const Elf64_Word Hash = SymbolNameIndex::hashName(Name);
+    Elf64_Word Pos = Hash & (Capacity - 1);
+    while (NameSlots[Pos].Symbol != 0)
+      Pos = (Pos + 1) & (Capacity - 1);
+    NameSlots[Pos] = {Hash, Index + 1};
+  }
+
+  std::vector<SnapshotDynamicEntry> DynamicEntries;
+  if (const auto Dynamic = file.getDynamicSection()) {
+    const auto DynamicStrings = Dynamic->getStringSection();
+    for (const auto& Entry : Dynamic->entries()) {
+      if (Entry.tag == DT_NULL)
+        break;
+      SnapshotDynamicEntry Record = {static_cast<Elf64_Sxword>(Entry.tag), Entry.value, 0, 0};
+      if (DynamicStrings && (Entry.tag == DT_NEEDED || Entry.tag == DT_SONAME ||
+                             Entry.tag == DT_RPATH || Entry.tag == DT_RUNPATH)) {
+        addString(Strings, DynamicStrings->getStringView(static_cast<Elf64_Word>(Entry.value)),
+                  Record.NameOffset, Record.NameLength);
+      }
+      DynamicEntries.push_back(Record);
+    }
+  }
+
+  std::string BuildId;
+  for (const auto& Notes : file.noteSections()) {
+    for (const auto& Entry : Notes->getAllEntries()) {
+      if (Entry->Type == NT_GNU_BUILD_ID && Entry->Name == "GNU" && BuildId.empty())
+        BuildId = Entry->Description;
+    }
+  }
+
+  std::string Contents(sizeof(Header), '\0');
+  addTable(Contents, Header.Tables[SectionTable], Sections);
+  addTable(Contents, Header.Tables[SegmentTable], Segments);
+  addTable(Contents, Header.Tables[SegmentSectionTable], SegmentSections);
+  addTable(Contents, Header.Tables[SymbolTable], Symbols);
+  addTable(Contents, Header.Tables[EnclosingTable], EnclosingSymbols);
+  addTable(Contents, Header.Tables[NameSlotTable], NameSlots);
+  addTable(Contents, Header.Tables[DynamicTable], DynamicEntries);
+  addTable(Contents, Header.Tables[StringTable], Strings.data(), Strings.size(), 1);
+  addTable(Contents, Header.Tables[BuildIdTable], BuildId.data(), BuildId.size(), 1);
+  Header.TotalSize = Contents.size();
+  std::memcpy(&Contents[0], &Header, sizeof(Header));
+
+  // the metadata may have been read from another version of the file, whose
+  // snapshot would be accepted for the current version forever
+  if (FileIdentity::fromPath(file.getName()) != source)
+    return false;
+
+  // readers either see the old or the complete new snapshot, every writer
+  // gets its own temporary file, so concurrent writers do not interfere
+  std::string Temporary = path + ".XXXXXX";
+  const int Descriptor = ::mkstemp(&Temporary[0]);
+  if (Descriptor < 0) {
+    throw std::runtime_error("Could not write snapshot!");
+  }
+  bool Written = ::fchmod(Descriptor, 0644) == 0;
+  for (std::size_t Done = 0; Written && Done < Contents.size();) {
+    const ssize_t Result = ::write(Descriptor, Contents.data() + Done, Contents.size() - Done);
+    if (Result < 0 && errno == EINTR)
+      continue;
+    Written = Result > 0;
+    Done += Written ? static_cast<std::size_t>(Result) : 0;
+  }
+  Written = ::close(Descriptor) == 0 && Written;
+  if (!Written) {
+    std::remove(Temporary.c_str());
+    throw std::runtime_error("Could not write snapshot!");
+  }
+  if (std::rename(Temporary.c_str(), path.c_str()) != 0) {
+    std::remove(Temporary.c_str());
+    throw std::runtime_error("Could not write snapshot!");
+  }
+  return true;
+}
+
+// Opens and validates a snapshot
+std::shared_ptr<const MetadataSnapshot> MetadataSnapshot::open(const std::string& path,
+                                                               const std::string& sourcePath) {
+  std::shared_ptr<MetadataSnapshot> Result(new MetadataSnapshot());
+  try {
+    Result->Source = FileIdentity::fromPath(sourcePath);
+    Result->Image = std::make_shared<MappedImageSource>(path);
+  } catch (const std::runtime_error&) {
+    return nullptr;
+  }
+
+  const char* Data = Result->Image->getResidentData();
+  const Elf64_Xword Size = Result->Image->getSize();
+  if (Size < sizeof(SnapshotHeader))
+    return nullptr;
+
+  SnapshotHeader Header;
+  std::memcpy(&Header, Data, sizeof(Header));
+  if (std::memcmp(Header.Magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 ||
+      Header.Version != FormatVersion || Header.ByteOrder != SnapshotByteOrder ||
+      Header.TotalSize != Size)
+    return nullptr;
+
+  // a snapshot of an older version of the file must not be used
+  const FileIdentity Recorded = {Header.Device, Header.Inode, Header.ModificationTime, Header.Size};
+  if (Recorded != Result->Source)
+    return nullptr;
+  Result->Info = Header.Info;
+
+  SnapshotArray<char> Strings;
+  if (!getTable(Data, Size, Header.Tables[SectionTable], Result->Sections) ||
+      !getTable(Data, Size, Header.Tables[SegmentTable], Result->Segments) ||
+      !getTable(Data, Size, Header.Tables[SegmentSectionTable], Result->SegmentSections) ||
+      !getTable(Data, Size, Header.Tables[SymbolTable], Result->Symbols) ||
+      !getTable(Data, Size, Header.Tables[EnclosingTable], Result->EnclosingSymbols) ||
+      !getTable(Data, Size, Header.Tables[NameSlotTable], Result->NameSlots) ||
+      !getTable(Data, Size, Header.Tables[DynamicTable], Result->DynamicEntries) ||
+      !getTable(Data, Size, Header.Tables[StringTable], Strings) ||
+      !getTable(Data, Size, Header.Tables[BuildIdTable], Result->BuildId))
+    return nullptr;
+  Result->Strings = StringView(Strings.begin(), Strings.size());
+
+  const std::size_t Capacity = Result->NameSlots.size();
+  if (Capacity == 0 || (Capacity & (Capacity - 1)) != 0 ||
+      Result->EnclosingSymbols.size() != Result->Symbols.size())
+    return nullptr;
+
+  return Result;
+}
+
+// Opens a snapshot or writes a new one
+std::shared_ptr<const MetadataSnapshot> MetadataSnapshot::openOrCreate(
+    const std::string& path, const std::string& sourcePath, const LoadMode mode) {
+  if (auto Result = open(path, sourcePath))
+    return Result;
+
+  const FileIdentity Identity = FileIdentity::fromPath(sourcePath);
+  ELFFile File(sourcePath, mode);
+  if (!write(File, Identity, path))
+    return nullptr;
+  return open(path, sourcePath);
+}
+
+// Returns the section indexes of a segment
+SnapshotArray<Elf64_Word> MetadataSnapshot::getSectionsOfSegment(
+    const SnapshotSegment& segment) const {
+  if (segment.FirstSection > SegmentSections.size() ||
+      segment.SectionCount > SegmentSections.size() - segment.FirstSection)
+    return SnapshotArray<Elf64_Word>();
+  return SnapshotArray<Elf64_Word>(SegmentSections.begin() + segment.FirstSection,
+                                   segment.SectionCount);
+}
+
+// Looks up a section by name
+const SnapshotSection* MetadataSnapshot::findSection(const StringView& name) const {
+  for (const auto& Sec : Sections) {
+    if (getName(Sec) == name)
+      return &Sec;
+  }
+  return nullptr;
+}
+
+/// Returns the best symbol starting at the address of \p first that
+/// contains \p address.
+///
+/// \param symbols The symbols of the snapshot
+/// \param first The first symbol with that address
+/// \param address The address to look up
+/// \return The symbol or \p nullptr if none contains \p address
+static const SnapshotSymbol* findAt(const SnapshotArray<SnapshotSymbol>& symbols,
+                                    const SnapshotSymbol* first, Elf64_Addr address) {
+  const Elf64_Addr Start = first->Value;
+  for (; first != symbols.end() && first->Value == Start; ++first) {
+    if (first->contains(address))
+      return first;
+  }
+  return nullptr;
+}
+
+// Looks up the symbol containing an address
+const SnapshotSymbol* MetadataSnapshot::findSymbol(Elf64_Addr address) const {
+  auto Iter = std::upper_bound(Symbols.begin(), Symbols.end(), address,
+                               [](Elf64_Addr value, const SnapshotSymbol& symbol) {
+    return value < symbol.Value;
+  });
+  if (Iter == Symbols.begin())
+    return nullptr;
+
+  // the symbols starting at the same address are ordered by preference
+  auto byValue = [](const SnapshotSymbol& symbol, Elf64_Addr value) {
+    return symbol.Value < value;
+  };
+  const SnapshotSymbol* First = std::lower_bound(Symbols.begin(), Iter,
+                                                 std::prev(Iter)->Value, byValue);
+  if (const SnapshotSymbol* Result = findAt(Symbols, First, address))
+    return Result;
+
+  // follow the links to the enclosing symbols like the address index, links
+  // must point backwards, so a corrupted table cannot loop
+  std::size_t Current = First - Symbols.begin();
+  for (std::size_t Link = EnclosingSymbols[Current]; Link != 0 && Link - 1 < Current;
+       Link = EnclosingSymbols[Current]) {
+    Current = Link - 1;
+    if (Symbols[Current].contains(address)) {
+      First = std::lower_bound(Symbols.begin(), Symbols.begin() + Link,
+                               Symbols[Current].Value, byValue);
+      return findAt(Symbols, First, address);
+    }
+  }
+  return nullptr;
+}
+
+// Looks up the symbols with a name
+std::vector<const SnapshotSymbol*> MetadataSnapshot::findSymbols(const StringView& name) const {
+  std::vector<const SnapshotSymbol*> Result;
+  const Elf64_Word Hash = SymbolNameIndex::hashName(name);
+  const std::size_t Mask = NameSlots.size() - 1;
+
+  // the number of probes is bounded, a corrupted table may have no empty slot
+  std::size_t Pos = Hash & Mask;
+  for (std::size_t Probes = 0; Probes < NameSlots.size() && NameSlots[Pos].Symbol != 0;
+       ++Probes, Pos = (Pos + 1) & Mask) {
+    const SnapshotNameSlot& Slot = NameSlots[Pos];
+    if (Slot.Hash == Hash && Slot.Symbol <= Symbols.size() &&
+        getName(Symbols[Slot.Symbol - 1]) == name)
+      Result.push_back(&Symbols[Slot.Symbol - 1]);
+  }
+  return Result;
+}
+
+// Looks up a dynamic section entry
+const SnapshotDynamicEntry* MetadataSnapshot::findDynamicEntry(Elf64_Sxword tag) const {
+  for (const auto& Entry : DynamicEntries) {
+    if (Entry.Tag == tag)
+      return &Entry;
+  }
+  return nullptr;
+}
+
+} // end of namespace libelfpp
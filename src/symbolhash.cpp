@@ -0,0 +1,172 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        symbolhash.cpp
+ * \brief       Source file implementing the lookup of dynamic symbols through
+ *              the hash tables of an ELF file
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p SymbolHashTable.
+ */
+
+#include "libelfpp/symbolhash.h"
+#include <cstring>
+
+namespace libelfpp {
+
+/// Number of words in the header of a GNU hash table
+static const Elf64_Xword GnuHeaderWords = 4;
+
+/// Number of words in the header of a SysV hash table
+static const Elf64_Xword SysVHeaderWords = 2;
+
+// Creates the lookup
+SymbolHashTable::SymbolHashTable(const std::shared_ptr<Section>& hash, const char* data,
+                                 const std::shared_ptr<SymbolSection>& symbols,
+                                 const EndianessConverter& converter, bool is64Bit) :
+    Hash(hash), Data(data), Words(data ? hash->getSize() / sizeof(uint32_t) : 0),
+    Symbols(symbols), Range(symbols->symbols()), Converter(converter), Is64Bit(is64Bit) {}
+
+// Returns a word of the hash table
+Elf64_Word SymbolHashTable::getWord(Elf64_Xword index) const {
+  uint32_t Word;
+  std::memcpy(&Word, Data + index * sizeof(Word), sizeof(Word));
+  return Converter(Word);
+}
+
+// Checks if a symbol satisfies a lookup
+bool SymbolHashTable::isMatch(const SymbolRef& symbol, const StringView& name) const {
+  // the dynamic linker ignores undefined and local symbols
+  return symbol.sectionIndex != SHN_UNDEF && symbol.bind != STB_LOCAL &&
+      symbol.name == name;
+}
+
+// Computes the GNU hash
+Elf64_Word SymbolHashTable::gnuHash(const StringView& name) {
+  uint32_t Hash = 5381;
+  for (char C : name) {
+    Hash = Hash * 33 + static_cast<unsigned char>(C);
+  }
+  return Hash;
+}
+
+// Computes the SysV hash
+Elf64_Word SymbolHashTable::sysvHash(const StringView& name) {
+  uint32_t Hash = 0;
+  for (char C : name) {
+    Hash = (Hash << 4) + static_cast<unsigned char>(C);
+    uint32_t High = Hash & 0xF0000000;
+    if (High)
+      Hash ^= High >> 24;
+    Hash &= ~High;
+  }
+  return Hash;
+}
+
+// Looks up a symbol
+SymbolLookupResult SymbolHashTable::find(const StringView& name) const {
+  return getType() == SHT_GNU_HASH ? findGnu(name) : findSysV(name);
+}
+
+// Looks up a symbol in a GNU hash table
+SymbolLookupResult SymbolHashTable::findGnu(const StringView& name) const {
+  const SymbolLookupResult NotFound = {false, 0, SymbolRef()};
+  if (Words < GnuHeaderWords)
+    return NotFound;
+
+  const Elf64_Word BucketCount = getWord(0);
+  const Elf64_Word SymbolOffset = getWord(1);
+  const Elf64_Word BloomSize = getWord(2);
+  const Elf64_Word BloomShift = getWord(3);
+  const Elf64_Xword BloomWords = Is64Bit ? 2 : 1;
+  const Elf64_Xword Buckets = GnuHeaderWords + Elf64_Xword(BloomSize) * BloomWords;
+  const Elf64_Xword Chains = Buckets + BucketCount;
+  if (BucketCount == 0 || BloomSize == 0 || Chains > Words)
+    return NotFound;
+
+  // the bloom filter rules out most names that are not defined
+  const Elf64_Word NameHash = gnuHash(name);
+  const unsigned int Bits = Is64Bit ? 64 : 32;
+  const Elf64_Xword BloomIndex = (NameHash / Bits) % BloomSize;
+  uint64_t Bloom;
+  if (Is64Bit) {
+    std::memcpy(&Bloom, Data + (GnuHeaderWords + 2 * BloomIndex) * sizeof(uint32_t), sizeof(Bloom));
+    Bloom = Converter(Bloom);
+  } else {
+    Bloom = getWord(GnuHeaderWords + BloomIndex);
+  }
+  const uint64_t Mask = (uint64_t(1) << (NameHash % Bits)) |
+      (uint64_t(1) << ((NameHash >> (BloomShift % 32)) % Bits));
+  if ((Bloom & Mask) != Mask)
+    return NotFound;
+
+  Elf64_Xword Index = getWord(Buckets + NameHash % BucketCount);
+  if (Index < SymbolOffset)
+    return NotFound;
+
+  // the chain holds the hashes of the symbols of the bucket, the lowest bit
+  // marks the end of the chain
+  for (; Index < Range.size() && Chains + (Index - SymbolOffset) < Words; ++Index) {
+    const Elf64_Word ChainHash = getWord(Chains + (Index - SymbolOffset));
+    if ((ChainHash | 1) == (NameHash | 1)) {
+      SymbolRef Symbol = Range[Index];
+      if (isMatch(Symbol, name))
+        return {true, Index, Symbol};
+    }
+    if (ChainHash & 1)
+      break;
+  }
+  return NotFound;
+}
+
+// Looks up a symbol in a SysV hash table
+SymbolLookupResult SymbolHashTable::findSysV(const StringView& name) const {
+  const SymbolLookupResult NotFound = {false, 0, SymbolRef()};
+  if (Words < SysVHeaderWords)
+    return NotFound;
+
+  const Elf64_Word BucketCount = getWord(0);
+  const Elf64_Word ChainCount = getWord(1);
+  const Elf64_Xword Chains = SysVHeaderWords + Elf64_Xword(BucketCount);
+  if (BucketCount == 0 || Chains + ChainCount > Words)
+    return NotFound;
+
+  // a chain can not be longer than the number of symbols, anything longer is
+  // a loop in a corrupted table
+  Elf64_Xword Index = getWord(SysVHeaderWords + sysvHash(name) % BucketCount);
+  for (Elf64_Xword Steps = 0; Index != STN_UNDEF && Index < ChainCount && Steps < ChainCount; ++Steps) {
+    if (Index < Range.size()) {
+      SymbolRef Symbol = Range[Index];
+      if (isMatch(Symbol, name))
+        return {true, Index, Symbol};
+    }
+    Index = getWord(Chains + Index);
+  }
+  return NotFound;
+}
+
+} // end of namespace libelfpp
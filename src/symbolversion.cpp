@@ -0,0 +1,154 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * \file        symbolversion.cpp
+ * \brief       Source file implementing the decoding of the symbol versions
+ *              of the dynamic symbols of an ELF file
+ * \author      Kevin Kirchner
+ * \date        2017
+ * \copyright   MIT License
+ *
+ * This source file implements the class \p SymbolVersionTable.
+ */
+
+#include "libelfpp/symbolversion.h"
+#include <cstring>
+
+namespace libelfpp {
+
+/// Reads a record of a versioning section. The layout of the records is the
+/// same for 32 and 64 Bit files.
+///
+/// \param section The data of the section
+/// \param offset Offset of the record in the section
+/// \param record Set to the record if it is within the section
+/// \return \p false if the record is not within the section
+template<class T>
+static bool readRecord(const SymbolVersionTable::SectionData& section, Elf64_Xword offset,
+                       T& record) {
+  if (!section.Data || offset > section.Size || sizeof(T) > section.Size - offset)
+    return false;
+  std::memcpy(&record, section.Data + offset, sizeof(T));
+  return true;
+}
+
+// Decodes the versioning sections
+SymbolVersionTable::SymbolVersionTable(const std::shared_ptr<SymbolSection>& symbols,
+                                       const SectionData& versym, const SectionData& verdef,
+                                       const SectionData& verneed,
+                                       const EndianessConverter& converter) :
+    Symbols(symbols), Range(symbols->symbols()), Versyms(), Versions(), ByIndex() {
+  if (versym.Data) {
+    Versyms.resize(versym.Size / sizeof(Elf64_Versym));
+    for (Elf64_Xword Index = 0; Index < Versyms.size(); ++Index) {
+      Elf64_Versym Entry;
+      std::memcpy(&Entry, versym.Data + Index * sizeof(Entry), sizeof(Entry));
+      Versyms[Index] = converter(Entry);
+    }
+  }
+  decodeDefinitions(verdef, converter);
+  decodeRequirements(verneed, converter);
+}
+
+// Returns a string of the dynamic string table
+StringView SymbolVersionTable::getString(Elf64_Word offset) const {
+  auto Strings = Symbols->getStringSection();
+  return Strings ? Strings->getStringView(offset) : StringView();
+}
+
+// Adds a version
+void SymbolVersionTable::addVersion(const SymbolVersion& version) {
+  const Elf64_Half Index = version.Index & 0x7fff;
+  if (Index >= ByIndex.size())
+    ByIndex.resize(Index + 1, 0);
+  Versions.push_back(version);
+  // the first version with an index wins
+  if (ByIndex[Index] == 0)
+    ByIndex[Index] = static_cast<Elf64_Word>(Versions.size());
+}
+
+// Decodes the version definitions
+void SymbolVersionTable::decodeDefinitions(const SectionData& verdef,
+                                           const EndianessConverter& converter) {
+  Elf64_Xword Offset = 0;
+  for (Elf64_Word Def = 0; Def < verdef.Count; ++Def) {
+    Elf64_Verdef Entry;
+    if (!readRecord(verdef, Offset, Entry) || converter(Entry.vd_version) != VER_DEF_CURRENT)
+      return;
+
+    // the first auxiliary entry holds the name, the others the parents
+    Elf64_Verdaux Aux;
+    if (converter(Entry.vd_cnt) != 0 && readRecord(verdef, Offset + converter(Entry.vd_aux), Aux)) {
+      addVersion({getString(converter(Aux.vda_name)), StringView(), converter(Entry.vd_ndx),
+                  converter(Entry.vd_flags), converter(Entry.vd_hash), true});
+    }
+
+    const Elf64_Word Next = converter(Entry.vd_next);
+    if (Next == 0)
+      return;
+    Offset += Next;
+  }
+}
+
+// Decodes the version requirements
+void SymbolVersionTable::decodeRequirements(const SectionData& verneed,
+                                            const EndianessConverter& converter) {
+  Elf64_Xword Offset = 0;
+  for (Elf64_Word Need = 0; Need < verneed.Count; ++Need) {
+    Elf64_Verneed Entry;
+    if (!readRecord(verneed, Offset, Entry) || converter(Entry.vn_version) != VER_NEED_CURRENT)
+      return;
+
+    const StringView File = getString(converter(Entry.vn_file));
+    Elf64_Xword AuxOffset = Offset + converter(Entry.vn_aux);
+    for (Elf64_Half Ver = 0; Ver < converter(Entry.vn_cnt); ++Ver) {
+      Elf64_Vernaux Aux;
+      if (!readRecord(verneed, AuxOffset, Aux))
+        break;
+      addVersion({getString(converter(Aux.vna_name)), File, converter(Aux.vna_other),
+                  converter(Aux.vna_flags), converter(Aux.vna_hash), false});
+
+      const Elf64_Word Next = converter(Aux.vna_next);
+      if (Next == 0)
+        break;
+      AuxOffset += Next;
+    }
+
+    const Elf64_Word Next = converter(Entry.vn_next);
+    if (Next == 0)
+      return;
+    Offset += Next;
+  }
+}
+
+// Looks up a version by index
+const SymbolVersion* SymbolVersionTable::findVersion(Elf64_Half versionIndex) const {
+  if (versionIndex <= VER_NDX_GLOBAL || versionIndex >= ByIndex.size() ||
+      ByIndex[versionIndex] == 0)
+    return nullptr;
+  return &Versions[ByIndex[versionIndex] - 1];
+}
+
+} // end of namespace libelfpp
@@ -23,11 +23,106 @@
  */
 
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 #include "catch.h"
 #include "libelfpp/libelfpp.h"
+#include "libelfpp/elfview.h"
+#include "libelfpp/corpus.h"
+#include "libelfpp/filecache.h"
+#include "libelfpp/snapshot.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
 
 using namespace libelfpp;
 
+// counts heap allocations, so tests can check that code does not allocate
+static std::atomic<std::size_t> AllocationCount(0);
+
+void* operator new(std::size_t size) {
+  ++AllocationCount;
+  if (void* Result = std::malloc(size ? size : 1))
+    return Result;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+// a symbol of an image built by makeSymbolImage
+struct TestSymbol {
+  const char* name;
+  Elf64_Addr value;
+  Elf64_Xword size;
+};
+
+// builds a 64 bit host endian relocatable file whose .symtab holds the given
+// functions, all defined in a .text section at 0x1000
+static std::string makeSymbolImage(const std::vector<TestSymbol>& symbols) {
+  std::string strtab(1, '\0');
+  std::string symtab(sizeof(Elf64_Sym), '\0');
+  for (const auto& symbol : symbols) {
+    Elf64_Sym sym;
+    std::memset(&sym, 0, sizeof(sym));
+    sym.st_name = static_cast<Elf64_Word>(strtab.size());
+    sym.st_info = ELF64_ST_INFO(STB_GLOBAL, STT_FUNC);
+    sym.st_shndx = 1;
+    sym.st_value = symbol.value;
+    sym.st_size = symbol.size;
+    symtab.append(reinterpret_cast<const char*>(&sym), sizeof(sym));
+    strtab.append(symbol.name).push_back('\0');
+  }
+  const std::string shstrtab("\0.text\0.symtab\0.strtab\0.shstrtab\0", 34);
+
+  std::string image(sizeof(Elf64_Ehdr), '\0');
+  auto add = [&image](const std::string& data) {
+    image.resize((image.size() + 7) / 8 * 8, '\0');
+    const Elf64_Off offset = image.size();
+    image += data;
+    return offset;
+  };
+  const Elf64_Off symtabOffset = add(symtab);
+  const Elf64_Off strtabOffset = add(strtab);
+  const Elf64_Off shstrtabOffset = add(shstrtab);
+
+  Elf64_Shdr sections[5];
+  std::memset(sections, 0, sizeof(sections));
+  sections[1] = {1, SHT_NOBITS, SHF_ALLOC | SHF_EXECINSTR, 0x1000, 0, 0x1000, 0, 0, 16, 0};
+  sections[2] = {7, SHT_SYMTAB, 0, 0, symtabOffset, symtab.size(), 3, 1, 8, sizeof(Elf64_Sym)};
+  sections[3] = {15, SHT_STRTAB, 0, 0, strtabOffset, strtab.size(), 0, 0, 1, 0};
+  sections[4] = {23, SHT_STRTAB, 0, 0, shstrtabOffset, shstrtab.size(), 0, 0, 1, 0};
+  const Elf64_Off sectionsOffset = add(std::string(reinterpret_cast<const char*>(sections),
+                                                   sizeof(sections)));
+
+  Elf64_Ehdr header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.e_ident, ELFMAG, SELFMAG);
+  header.e_ident[EI_CLASS] = ELFCLASS64;
+  const uint16_t one = 1;
+  header.e_ident[EI_DATA] = *reinterpret_cast<const unsigned char*>(&one) ? ELFDATA2LSB : ELFDATA2MSB;
+  header.e_ident[EI_VERSION] = EV_CURRENT;
+  header.e_type = ET_REL;
+  header.e_machine = EM_X86_64;
+  header.e_version = EV_CURRENT;
+  header.e_shoff = sectionsOffset;
+  header.e_ehsize = sizeof(Elf64_Ehdr);
+  header.e_shentsize = sizeof(Elf64_Shdr);
+  header.e_shnum = 5;
+  header.e_shstrndx = 4;
+  std::memcpy(&image[0], &header, sizeof(header));
+  return image;
+}
+
 TEST_CASE("EndianessConverter", "[libelfpp]") {
   EndianessConverter Converter(true, true);
   REQUIRE(Converter(0xDEADBEEF) == 0xDEADBEEF);
@@ -56,8 +151,1007 @@ TEST_CASE("ELFFile", "[libelfpp]") {
   REQUIRE(file.getName().compare("libelfpp.so") == 0);
 }
 
+TEST_CASE("Mapped load mode", "[libelfpp]") {
+  REQUIRE_THROWS_AS(ELFFile("nonexistingfilename", LoadMode::Map), std::runtime_error);
+
+  for (const auto& name : {"libelfpp.so", "hello_world", "fibonacci", "libexamplelib.so"}) {
+    ELFFile read(name);
+    ELFFile mapped(name, LoadMode::Map);
+
+    REQUIRE(mapped.sections().size() == read.sections().size());
+    for (size_t i = 0; i < read.sections().size(); ++i) {
+      REQUIRE(mapped.sections()[i]->getName() == read.sections()[i]->getName());
+      REQUIRE(mapped.sections()[i]->getDataString() == read.sections()[i]->getDataString());
+    }
+    REQUIRE(mapped.segments().size() == read.segments().size());
+    for (size_t i = 0; i < read.segments().size(); ++i) {
+      REQUIRE(mapped.segments()[i]->getDataString() == read.segments()[i]->getDataString());
+      REQUIRE(mapped.segments()[i]->getSectionNumber() == read.segments()[i]->getSectionNumber());
+    }
+    REQUIRE(mapped.getNeededLibraries() == read.getNeededLibraries());
+    REQUIRE(mapped.symbolSections().size() == read.symbolSections().size());
+    auto symbols = mapped.symbolSections()[0]->getAllSymbols();
+    REQUIRE(symbols.size() == read.symbolSections()[0]->getNumSymbols());
+    REQUIRE(symbols.back()->name == read.symbolSections()[0]->getSymbol(symbols.size() - 1)->name);
+  }
+}
+
+TEST_CASE("Sections and segments share one image", "[libelfpp]") {
+  for (auto mode : {LoadMode::Read, LoadMode::Map, LoadMode::Lazy}) {
+    ELFFile fib("fibonacci", mode);
+    auto load = fib.segments().at(2);
+    REQUIRE(load->getType() == PT_LOAD);
+    for (const auto& section : load->getAssociatedSections()) {
+      if (section->getSize() == 0 || section->getType() == SHT_NOBITS || mode == LoadMode::Lazy)
+        continue;
+      REQUIRE(section->getData() == load->getData() + (section->getOffset() - load->getOffset()));
+    }
+  }
+}
+
+TEST_CASE("Big endian headers", "[libelfpp]") {
+  // ELF header and one program header of a big endian 64 bit executable
+  std::string image(120, '\0');
+  auto put = [&image](size_t offset, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i)
+      image[offset + i] = static_cast<char>(value >> (8 * (size - 1 - i)));
+  };
+  image.replace(0, 4, ELFMAG);
+  put(EI_CLASS, ELFCLASS64, 1);
+  put(EI_DATA, ELFDATA2MSB, 1);
+  put(EI_VERSION, EV_CURRENT, 1);
+  put(16, ET_EXEC, 2);
+  put(18, EM_PPC64, 2);
+  put(20, EV_CURRENT, 4);
+  put(24, 0x10000100, 8);
+  put(32, 64, 8);
+  put(52, 64, 2);
+  put(54, 56, 2);
+  put(56, 1, 2);
+  put(64, PT_LOAD, 4);
+  put(68, PF_R | PF_X, 4);
+  put(80, 0x10000000, 8);
+  put(96, 120, 8);
+  put(104, 0x2000, 8);
+
+  ELFFile file(image.data(), image.size());
+  REQUIRE_FALSE(file.getHeader()->isLittleEndian());
+  REQUIRE(file.getHeader()->getELFType() == ET_EXEC);
+  REQUIRE(file.getHeader()->getMachine() == EM_PPC64);
+  REQUIRE(file.getHeader()->getEntryPoint() == 0x10000100);
+  REQUIRE(file.getHeader()->getProgramHeaderNumber() == 1);
+  REQUIRE(file.getHeader()->getHeaderSize() == 64);
+  REQUIRE(file.segments().size() == 1);
+  REQUIRE(file.segments()[0]->getType() == PT_LOAD);
+  REQUIRE(file.segments()[0]->getFlagsString() == "RX");
+  REQUIRE(file.segments()[0]->getVirtualAddress() == 0x10000000);
+  REQUIRE(file.segments()[0]->getFileSize() == 120);
+  REQUIRE(file.segments()[0]->getMemorySize() == 0x2000);
+
+  ELFView<Elf64_Ehdr, false> view(image.data(), image.size());
+  REQUIRE(view.isValid());
+  REQUIRE(view.getHeader().getMachine() == EM_PPC64);
+  REQUIRE(view.getSegments().size() == 1);
+  REQUIRE(view.getSegments()[0].getMemorySize() == 0x2000);
+}
+
+TEST_CASE("Compile-time views", "[libelfpp]") {
+  std::ifstream input("libelfpp.so", std::ios::binary);
+  const std::string image((std::istreambuf_iterator<char>(input)),
+                          std::istreambuf_iterator<char>());
+  typedef ELFView<Elf64_Ehdr, true> View;
+
+  REQUIRE_FALSE((ELFView<Elf32_Ehdr, true>::matches(image.data(), image.size())));
+  REQUIRE_FALSE((ELFView<Elf64_Ehdr, false>::matches(image.data(), image.size())));
+  REQUIRE_FALSE(View::matches(image.data(), 10));
+  View view(image.data(), image.size());
+  REQUIRE(view.isValid());
+
+  ELFFile file("libelfpp.so");
+  REQUIRE(view.getHeader().getEntryPoint() == file.getHeader()->getEntryPoint());
+  REQUIRE(view.getHeader().getMachine() == file.getHeader()->getMachine());
+  REQUIRE(view.getSegments().size() == file.segments().size());
+  REQUIRE(view.getSegments()[2].getVirtualAddress() == file.segments()[2]->getVirtualAddress());
+
+  auto sections = view.getSections();
+  REQUIRE(sections.size() == file.sections().size());
+  auto names = sections[view.getHeader().getSectionHeaderStringTableIndex()];
+  Elf64_Half index = 0;
+  for (auto section : sections) {
+    REQUIRE(section.getType() == file.sections()[index]->getType());
+    REQUIRE(section.getSize() == file.sections()[index]->getSize());
+    REQUIRE(view.getString(names, section.getNameStringOffset()) == file.sections()[index]->getName());
+    ++index;
+  }
+
+  for (const auto& symbols : file.symbolSections()) {
+    auto table = view.getSymbols(sections[symbols->getIndex()]);
+    auto strings = sections[symbols->getLink()];
+    REQUIRE(table.size() == symbols->getNumSymbols());
+    for (Elf64_Xword i = 0; i < table.size(); ++i) {
+      REQUIRE(view.getString(strings, table[i].getNameOffset()) == symbols->getSymbol(i)->name);
+      REQUIRE(table[i].getValue() == symbols->getSymbol(i)->value);
+      REQUIRE(table[i].getType() == symbols->getSymbol(i)->type);
+    }
+    // views can also be created on the sections of an ELFFile
+    REQUIRE(View::SymbolTable_t::fromSection(*symbols).size() == table.size());
+  }
+
+  for (const auto& relocations : file.relocationSections()) {
+    REQUIRE(relocations->getType() == SHT_RELA);
+    auto table = view.getRelocationsWithAddend(sections[relocations->getIndex()]);
+    REQUIRE(table.size() == relocations->getNumEntries());
+    Elf64_Xword i = 0;
+    for (auto entry : table) {
+      REQUIRE(entry.getOffset() == relocations->getEntry(i)->Offset);
+      REQUIRE(entry.getSymbolIndex() == relocations->getEntry(i)->SymbolIndex);
+      REQUIRE(entry.getAddend() == relocations->getEntry(i)->Addend);
+      ++i;
+    }
+  }
+
+  // tables that do not fit into the image are empty
+  View truncated(image.data(), 4096);
+  REQUIRE(truncated.isValid());
+  REQUIRE(truncated.getSections().empty());
+  REQUIRE(truncated.getSymbols(sections[file.symbolSections()[0]->getIndex()]).empty());
+
+  // sections whose data lies behind the end of the file have no entries
+  std::string patched = image;
+  const Elf64_Half dynsym = file.getSectionByName(".dynsym")->getIndex();
+  const Elf64_Off pastEnd = patched.size();
+  std::memcpy(&patched[view.getHeader().getSectionHeaderOffset() + dynsym * sizeof(Elf64_Shdr) +
+                       offsetof(Elf64_Shdr, sh_offset)], &pastEnd, sizeof(pastEnd));
+  ELFFile broken(patched.data(), patched.size());
+  REQUIRE(broken.sections()[dynsym]->getDataPointer() == nullptr);
+  REQUIRE(View::SymbolTable_t::fromSection(*broken.sections()[dynsym]).empty());
+}
+
+TEST_CASE("Symbol ranges", "[libelfpp]") {
+  ELFFile file("libelfpp.so");
+  REQUIRE(file.symbolSections().size() == 2);
+
+  for (const auto& section : file.symbolSections()) {
+    auto symbols = section->symbols();
+    REQUIRE(symbols.size() == section->getNumSymbols());
+    Elf64_Xword index = 0;
+    for (auto symbol : symbols) {
+      auto expected = section->getSymbol(index++);
+      REQUIRE(symbol.name == expected->name);
+      REQUIRE(symbol.value == expected->value);
+      REQUIRE(symbol.size == expected->size);
+      REQUIRE(symbol.type == expected->type);
+      REQUIRE(symbol.bind == expected->bind);
+      REQUIRE(symbol.sectionIndex == expected->sectionIndex);
+      REQUIRE(symbol.toSymbol().getTypeString() == expected->getTypeString());
+    }
+    REQUIRE(index == symbols.size());
+
+    // walking the symbols must not allocate memory
+    std::size_t before = AllocationCount;
+    Elf64_Xword names = 0;
+    for (auto symbol : section->symbols()) {
+      names += symbol.name.size();
+    }
+    std::size_t allocations = AllocationCount - before;
+    REQUIRE(allocations == 0);
+    REQUIRE(names > 0);
+  }
+
+  REQUIRE(StringView("main") == std::string("main"));
+  REQUIRE(StringView("main", 2) == "ma");
+  REQUIRE(StringView("main").startsWith("ma"));
+  REQUIRE(StringView("abc") < StringView("abd"));
+  REQUIRE(StringView("ab") < StringView("abc"));
+  REQUIRE(StringView().empty());
+}
+
+TEST_CASE("String views", "[libelfpp]") {
+  ELFFile file("libelfpp.so");
+  for (const auto& symbols : file.symbolSections()) {
+    auto strings = symbols->getStringSection();
+    const Elf64_Word size = static_cast<Elf64_Word>(strings->getSize());
+    REQUIRE(strings->getStringTable().size() == size);
+    REQUIRE(strings->getStringView(size).empty());
+    REQUIRE(strings->getStringView(size + 100).empty());
+
+    // every index, including those in the middle of a string
+    std::vector<Elf64_Word> starts;
+    for (Elf64_Word i = 0; i < size; ++i) {
+      REQUIRE(strings->getStringView(i) == strings->getString(i));
+      if (i == 0 || strings->getStringTable()[i - 1] == '\0')
+        starts.push_back(i);
+    }
+
+    strings->scanStrings();
+    strings->scanStrings();
+    for (size_t k = 0; k < starts.size(); ++k) {
+      Elf64_Word lhs = starts[k];
+      Elf64_Word rhs = starts[(k * 7) % starts.size()];
+      REQUIRE(strings->getStringView(lhs) == strings->getString(lhs));
+      REQUIRE(strings->isSameString(lhs, rhs) == (strings->getString(lhs) == strings->getString(rhs)));
+      REQUIRE(strings->isSameString(lhs + 1, rhs) == (strings->getString(lhs + 1) == strings->getString(rhs)));
+    }
+
+    // an empty string is at index 0 and at the end of every string
+    REQUIRE(strings->isSameString(0, starts[1] - 1));
+
+    std::size_t before = AllocationCount;
+    bool same = true;
+    for (size_t k = 1; k < starts.size(); ++k) {
+      same = same && !strings->getStringView(starts[k]).empty() &&
+          !strings->isSameString(starts[k], 0);
+    }
+    std::size_t allocations = AllocationCount - before;
+    REQUIRE(allocations == 0);
+    REQUIRE(same);
+  }
+}
+
+TEST_CASE("Section lookup", "[libelfpp]") {
+  for (const char* name : {"libelfpp.so", "fibonacci", "example_lib.o"}) {
+    ELFFile file(name);
+    std::size_t byName = 0;
+    for (const auto& section : file.sections()) {
+      auto& named = file.getSectionsByName(section->getName());
+      REQUIRE(std::find(named.begin(), named.end(), section) != named.end());
+      REQUIRE(file.getSectionByName(section->getName()) == named.front());
+      if (named.front() == section)
+        byName += named.size();
+
+      auto& typed = file.getSectionsByType(section->getType());
+      REQUIRE(std::find(typed.begin(), typed.end(), section) != typed.end());
+      for (const auto& other : typed) {
+        REQUIRE(other->getType() == section->getType());
+      }
+    }
+    REQUIRE(byName == file.sections().size());
+
+    REQUIRE(file.getSectionByName(".text")->getType() == SHT_PROGBITS);
+    REQUIRE(file.getSectionsByType(SHT_SYMTAB).size() <= 1);
+    REQUIRE(file.getSectionByName(".no_such_section") == nullptr);
+    REQUIRE(file.getSectionsByName(".no_such_section").empty());
+    REQUIRE(file.getSectionsByType(SHT_LOUSER).empty());
+    REQUIRE(ELFFile(file).getSectionByName(".text") == file.getSectionByName(".text"));
+  }
+}
+
+TEST_CASE("Layout index", "[libelfpp]") {
+  for (const char* name : {"libelfpp.so", "hello_world", "fibonacci", "example_lib.o"}) {
+    ELFFile file(name);
+    auto layout = file.getLayoutIndex();
+    REQUIRE(layout != nullptr);
+    REQUIRE(layout == ELFFile(file).getLayoutIndex());
+
+    for (const auto& segment : file.segments()) {
+      // the same sections as comparing every segment with every section
+      std::vector<std::shared_ptr<Section>> expected;
+      for (const auto& section : file.sections()) {
+        bool inside = section->getFlags() & SHF_ALLOC ?
+            segment->getVirtualAddress() <= section->getAddress() &&
+                section->getAddress() + section->getSize() <= segment->getVirtualAddress() + segment->getMemorySize() :
+            segment->getOffset() <= section->getOffset() &&
+                section->getOffset() + section->getSize() <= segment->getOffset() + segment->getFileSize();
+        if (inside)
+          expected.push_back(section);
+      }
+      REQUIRE(segment->getAssociatedSections() == expected);
+      for (const auto& section : expected) {
+        auto containing = layout->getSegmentsOfSection(section->getIndex());
+        REQUIRE(std::find(containing.begin(), containing.end(), segment) != containing.end());
+      }
+
+      if (segment->getType() == PT_LOAD && segment->getMemorySize() != 0) {
+        Elf64_Addr end = segment->getVirtualAddress() + segment->getMemorySize();
+        REQUIRE(layout->findSegmentByAddress(segment->getVirtualAddress()) == segment);
+        REQUIRE(layout->findSegmentByAddress(end - 1) == segment);
+        REQUIRE(layout->findSegmentByAddress(end) != segment);
+        REQUIRE(layout->findSegmentByOffset(segment->getOffset()) == segment);
+      }
+    }
+
+    for (const auto& section : file.sections()) {
+      if (section->getSize() == 0)
+        continue;
+      if (file.segments().empty()) {
+        REQUIRE(layout->findSectionByAddress(section->getAddress()) == nullptr);
+      } else if ((section->getFlags() & SHF_ALLOC) &&
+                 !(section->getFlags() & SHF_TLS && section->getType() == SHT_NOBITS)) {
+        REQUIRE(layout->findSectionByAddress(section->getAddress()) == section);
+        REQUIRE(layout->findSectionByAddress(section->getAddress() + section->getSize() - 1) == section);
+      }
+      if (section->getType() != SHT_NOBITS) {
+        REQUIRE(layout->findSectionByOffset(section->getOffset()) == section);
+        REQUIRE(layout->findSectionByOffset(section->getOffset() + section->getSize() - 1) == section);
+      }
+    }
+    REQUIRE(layout->findSegmentByAddress(~Elf64_Addr(0)) == nullptr);
+    REQUIRE(layout->findSectionByOffset(~Elf64_Off(0)) == nullptr);
+    REQUIRE(layout->getSegmentsOfSection(file.sections().size()).empty());
+  }
+}
+
+TEST_CASE("Address translation", "[libelfpp]") {
+  for (const char* name : {"libelfpp.so", "fibonacci"}) {
+    ELFFile file(name);
+    bool sawBss = false;
+    for (const auto& section : file.sections()) {
+      if (!(section->getFlags() & SHF_ALLOC) || (section->getFlags() & SHF_TLS) ||
+          section->getSize() == 0)
+        continue;
+
+      Elf64_Off offset = 0;
+      Elf64_Addr address = 0;
+      const char* data = file.getDataAtAddress(section->getAddress(), section->getSize());
+      REQUIRE(data != nullptr);
+      if (section->getType() == SHT_NOBITS) {
+        // loaded from the zero-filled tail of a segment
+        sawBss = true;
+        REQUIRE_FALSE(file.addressToOffset(section->getAddress(), offset));
+        REQUIRE(std::all_of(data, data + section->getSize(), [](char c) { return c == 0; }));
+        REQUIRE(file.getDataAtAddress(section->getAddress(), section->getSize()) == data);
+
+        // a range ending in the tail starts with the bytes from the file
+        auto segment = file.getLayoutIndex()->findSegmentByAddress(section->getAddress());
+        Elf64_Addr fileEnd = segment->getVirtualAddress() + segment->getFileSize();
+        if (fileEnd > segment->getVirtualAddress() && fileEnd <= section->getAddress()) {
+          const char* straddling = file.getDataAtAddress(fileEnd - 1, section->getAddress() + 1 - (fileEnd - 1));
+          REQUIRE(straddling != nullptr);
+          REQUIRE(straddling[0] == segment->getData()[segment->getFileSize() - 1]);
+        }
+        continue;
+      }
+
+      REQUIRE(file.addressToOffset(section->getAddress(), offset));
+      REQUIRE(offset == section->getOffset());
+      REQUIRE(file.offsetToAddress(section->getOffset(), address));
+      REQUIRE(address == section->getAddress());
+      REQUIRE(std::memcmp(data, section->getData(), section->getSize()) == 0);
+    }
+    REQUIRE(sawBss);
+
+    Elf64_Off offset = 0;
+    REQUIRE_FALSE(file.addressToOffset(~Elf64_Addr(0), offset));
+    REQUIRE(file.getDataAtAddress(~Elf64_Addr(0), 1) == nullptr);
+    std::shared_ptr<Segment> load;
+    for (const auto& segment : file.segments()) {
+      if (segment->getType() == PT_LOAD) {
+        load = segment;
+        break;
+      }
+    }
+    REQUIRE(load != nullptr);
+    REQUIRE(file.getDataAtAddress(load->getVirtualAddress(), load->getMemorySize() + 1) == nullptr);
+  }
+
+  // segments that can not be read or are too large to copy give nullptr
+  std::ifstream input("libexamplelib.so", std::ios::binary);
+  const std::string image((std::istreambuf_iterator<char>(input)),
+                          std::istreambuf_iterator<char>());
+  ELFFile lib("libexamplelib.so");
+  std::shared_ptr<Segment> load;
+  for (const auto& segment : lib.segments()) {
+    // the last one, so that enlarging it does not overlap other segments
+    if (segment->getType() == PT_LOAD && segment->getFileSize() > 0x48)
+      load = segment;
+  }
+  REQUIRE(load != nullptr);
+  const Elf64_Off header = lib.getHeader()->getProgramHeaderOffset() +
+      load->getIndex() * sizeof(Elf64_Phdr);
+  auto patch = [&image, header](size_t field, Elf64_Xword value) {
+    std::string patched = image;
+    std::memcpy(&patched[header + field], &value, sizeof(value));
+    return patched;
+  };
+
+  const std::string unreadable = patch(offsetof(Elf64_Phdr, p_offset), image.size());
+  ELFFile broken(unreadable.data(), unreadable.size());
+  REQUIRE(broken.segments()[load->getIndex()]->getDataPointer() == nullptr);
+  REQUIRE(broken.getDataAtAddress(load->getVirtualAddress() + 0x40, 8) == nullptr);
+
+  const Elf64_Xword huge = Elf64_Xword(1) << 62;
+  const std::string hostile = patch(offsetof(Elf64_Phdr, p_memsz), huge);
+  ELFFile large(hostile.data(), hostile.size());
+  const Elf64_Addr tail = load->getVirtualAddress() + load->getFileSize();
+  const char* zeros = large.getDataAtAddress(tail + 0x10000000, 8);
+  REQUIRE(zeros != nullptr);
+  REQUIRE(std::all_of(zeros, zeros + 8, [](char c) { return c == 0; }));
+  const char* straddling = large.getDataAtAddress(tail - 4, 8);
+  REQUIRE(straddling != nullptr);
+  REQUIRE(std::memcmp(straddling, load->getData() + load->getFileSize() - 4, 4) == 0);
+  REQUIRE(large.getDataAtAddress(tail, huge / 2) == nullptr);
+}
+
+TEST_CASE("Address index", "[libelfpp]") {
+  ELFFile file("libelfpp.so");
+  auto index = file.getAddressIndex();
+  REQUIRE(index == file.getAddressIndex());
+  REQUIRE(index == ELFFile(file).getAddressIndex());
+  REQUIRE_FALSE(index->getEntries().empty());
+  REQUIRE(index->find(0) == nullptr);
+
+  std::vector<Elf64_Addr> addresses;
+  bool aliases = false;
+  for (auto symbol : file.symbolSections()[1]->symbols()) {
+    if (symbol.type != STT_FUNC || symbol.sectionIndex == SHN_UNDEF || symbol.size == 0)
+      continue;
+    Elf64_Addr address = symbol.value + symbol.size / 2;
+    auto entry = index->find(address);
+    REQUIRE(entry != nullptr);
+    REQUIRE(entry->contains(address));
+    REQUIRE(entry->Symbol.value == symbol.value);
+
+    auto all = index->getAliases(*entry);
+    REQUIRE(std::find_if(all.begin(), all.end(), [&symbol](const IndexedSymbol* alias) {
+      return alias->Symbol.name == symbol.name;
+    }) != all.end());
+    aliases = aliases || all.size() > 1;
+    addresses.push_back(address);
+  }
+  REQUIRE(aliases);
+
+  std::sort(addresses.begin(), addresses.end());
+  addresses.insert(addresses.begin(), 0);
+  auto batch = index->findAll(addresses);
+  REQUIRE(batch.size() == addresses.size());
+  for (size_t i = 0; i < addresses.size(); ++i) {
+    REQUIRE(batch[i] == index->find(addresses[i]));
+  }
+
+  SymbolAddressIndex objects(file.symbolSections(), 1u << STT_OBJECT);
+  for (const auto& entry : objects.getEntries()) {
+    REQUIRE(entry.Symbol.type == STT_OBJECT);
+  }
+
+  // addresses behind a nested symbol belong to the enclosing symbol again
+  const std::string image = makeSymbolImage({{"outer", 0x1000, 0x100},
+                                             {"inner", 0x1010, 0x10},
+                                             {"middle", 0x1020, 0x40},
+                                             {"innermost", 0x1030, 0x8},
+                                             {"marker", 0x1050, 0},
+                                             {"other", 0x1200, 0x10}});
+  ELFFile nested(image.data(), image.size());
+  auto nestedIndex = nested.getAddressIndex();
+  REQUIRE(nestedIndex->getEntries().size() == 6);
+  const std::vector<std::pair<Elf64_Addr, const char*>> expected = {
+      {0x0fff, nullptr}, {0x1000, "outer"}, {0x1018, "inner"}, {0x1028, "middle"},
+      {0x1034, "innermost"}, {0x103c, "middle"}, {0x1050, "marker"}, {0x1051, "middle"},
+      {0x1080, "outer"}, {0x1100, nullptr}, {0x1205, "other"}, {0x1210, nullptr}};
+  std::vector<Elf64_Addr> probes;
+  for (const auto& probe : expected) {
+    auto entry = nestedIndex->find(probe.first);
+    if (probe.second) {
+      REQUIRE(entry != nullptr);
+      REQUIRE(entry->Symbol.name == probe.second);
+    } else {
+      REQUIRE(entry == nullptr);
+    }
+    probes.push_back(probe.first);
+  }
+  auto nestedBatch = nestedIndex->findAll(probes);
+  for (size_t i = 0; i < probes.size(); ++i) {
+    REQUIRE(nestedBatch[i] == nestedIndex->find(probes[i]));
+  }
+}
+
+TEST_CASE("Dynamic symbol lookup", "[libelfpp]") {
+  REQUIRE(SymbolHashTable::gnuHash("") == 5381);
+  REQUIRE(SymbolHashTable::gnuHash("printf") == 0x156b2bb8);
+  REQUIRE(SymbolHashTable::sysvHash("printf") == 0x077905a6);
+
+  for (const char* name : {"libexamplelib.so", "libexamplelib_sysv.so", "libelfpp.so", "hello_world"}) {
+    ELFFile file(name);
+    auto table = file.getSymbolHashTable();
+    REQUIRE(table != nullptr);
+    REQUIRE(table->getType() == (std::string(name) == "libexamplelib_sysv.so" ? SHT_HASH : SHT_GNU_HASH));
+
+    // every exported symbol is found, imported ones are not
+    auto symbols = table->getSymbolSection()->symbols();
+    for (Elf64_Xword i = 1; i < symbols.size(); ++i) {
+      auto result = file.findDynamicSymbol(symbols[i].name);
+      if (symbols[i].sectionIndex == SHN_UNDEF || symbols[i].bind == STB_LOCAL) {
+        REQUIRE((!result || result.Symbol.sectionIndex != SHN_UNDEF));
+      } else {
+        REQUIRE(result);
+        REQUIRE(result.Index == i);
+        REQUIRE(result.Symbol.value == symbols[i].value);
+      }
+    }
+    REQUIRE_FALSE(file.findDynamicSymbol("no_such_symbol_in_this_file"));
+    REQUIRE_FALSE(file.findDynamicSymbol(""));
+  }
+
+  ELFFile lib("libexamplelib_sysv.so");
+  REQUIRE(lib.findDynamicSymbol("_Z17printSomethingOutRKNSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEEERSo"));
+  REQUIRE_FALSE(lib.findDynamicSymbol("printSomethingOut"));
+  // copies share the lookup, no matter which one builds it
+  ELFFile copy(lib);
+  REQUIRE(copy.getSymbolHashTable() != nullptr);
+  REQUIRE(copy.getSymbolHashTable() == lib.getSymbolHashTable());
+}
+
+TEST_CASE("Name index", "[libelfpp]") {
+  REQUIRE(SymbolNameIndex::hashName("") == 2166136261u);
+  REQUIRE(SymbolNameIndex::hashName("a") == 0xe40c292c);
+
+  for (const char* name : {"example_lib.o", "libelfpp.so"}) {
+    ELFFile file(name);
+    auto index = file.getNameIndex();
+    REQUIRE(index == file.getNameIndex());
+    REQUIRE(index == ELFFile(file).getNameIndex());
+
+    // every named symbol is found at its position in its section
+    Elf64_Xword named = 0;
+    for (const auto& section : file.symbolSections()) {
+      Elf64_Xword i = 0;
+      for (auto symbol : section->symbols()) {
+        if (!symbol.name.empty()) {
+          ++named;
+          auto matches = index->find(symbol.name);
+          REQUIRE_FALSE(matches.empty());
+          REQUIRE(std::find_if(matches.begin(), matches.end(), [&](const IndexedSymbol& entry) {
+            return entry.SymbolSectionIndex == section->getIndex() && entry.SymbolIndex == i;
+          }) != matches.end());
+          for (const auto& entry : matches) {
+            REQUIRE(entry.Symbol.name == symbol.name);
+          }
+        }
+        ++i;
+      }
+    }
+    REQUIRE(index->getEntries().size() == named);
+    REQUIRE(index->find("no_such_symbol_in_this_file").empty());
+    REQUIRE(index->find("").empty());
+    REQUIRE(index->findPrefix("").size() == named);
+    REQUIRE(index->findPrefix("no_such_prefix").empty());
+
+    auto matches = index->findPrefix("_Z17printSomethingOut");
+    REQUIRE((std::string(name) == "example_lib.o" ? matches.size() == 1 : matches.empty()));
+  }
+
+  // exported symbols are in .dynsym and .symtab
+  ELFFile file("libelfpp.so");
+  auto index = file.getNameIndex();
+  auto matches = index->find("_ZNK8libelfpp7ELFFile12getNameIndexEv");
+  REQUIRE(matches.size() == 2);
+  REQUIRE(matches[0].SymbolSectionIndex != matches[1].SymbolSectionIndex);
+  REQUIRE(matches[0].Symbol.value == matches[1].Symbol.value);
+
+  size_t expected = 0;
+  for (const auto& entry : index->getEntries()) {
+    if (entry.Symbol.name.startsWith("_ZN8libelfpp15SymbolNameIndex"))
+      ++expected;
+  }
+  auto members = index->findPrefix("_ZN8libelfpp15SymbolNameIndex");
+  REQUIRE(expected > 0);
+  REQUIRE(members.size() == expected);
+  for (size_t i = 1; i < members.size(); ++i) {
+    REQUIRE_FALSE(members[i].Symbol.name < members[i - 1].Symbol.name);
+  }
+
+  size_t before = AllocationCount;
+  bool found = !index->find("_ZNK8libelfpp7ELFFile12getNameIndexEv").empty();
+  size_t allocations = AllocationCount - before;
+  REQUIRE(found);
+  REQUIRE(allocations == 0);
+}
+
+TEST_CASE("Read statistics", "[libelfpp]") {
+  std::ifstream input("libelfpp.so", std::ios::binary | std::ios::ate);
+  const Elf64_Xword size = static_cast<Elf64_Xword>(input.tellg());
+
+  // headers and data are read in a few large reads, every byte only once
+  ELFFile read("libelfpp.so");
+  REQUIRE(read.getIOStatistics().ReadCalls > 0);
+  REQUIRE(read.getIOStatistics().ReadCalls < 10);
+  REQUIRE(read.getIOStatistics().BytesRead <= size);
+
+  ELFFile mapped("libelfpp.so", LoadMode::Map);
+  REQUIRE(mapped.getIOStatistics().ReadCalls == 0);
+  REQUIRE(mapped.getIOStatistics().BytesRead == 0);
+
+  // lazily loaded data is read with a single read on first access
+  ELFFile lazy("libelfpp.so", LoadMode::Lazy);
+  auto before = lazy.getIOStatistics();
+  REQUIRE(before.ReadCalls < 5);
+  lazy.getDynamicSection()->getData();
+  REQUIRE(lazy.getIOStatistics().ReadCalls == before.ReadCalls + 1);
+  REQUIRE(lazy.getIOStatistics().BytesRead == before.BytesRead + lazy.getDynamicSection()->getSize());
+  lazy.getDynamicSection()->getData();
+  REQUIRE(lazy.getIOStatistics().ReadCalls == before.ReadCalls + 1);
+}
+
+TEST_CASE("Lazy load mode", "[libelfpp]") {
+  ELFFile read("libexamplelib.so");
+  ELFFile lazy("libexamplelib.so", LoadMode::Lazy);
+
+  REQUIRE(lazy.getNeededLibraries() == read.getNeededLibraries());
+  REQUIRE(lazy.noteSections()[0]->getEntry(0)->Description ==
+          read.noteSections()[0]->getEntry(0)->Description);
+  REQUIRE(lazy.symbolSections()[0]->getSymbol(11)->name == "_end");
+
+  // concurrent first accesses must all observe the same, fully read data
+  auto text = lazy.sections().at(11);
+  std::vector<const char*> results(8, nullptr);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < results.size(); ++i) {
+    threads.emplace_back([&results, &text, i]() { results[i] = text->getData(); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto result : results) {
+    REQUIRE(result == results[0]);
+  }
+  REQUIRE(text->getDataString() == read.sections().at(11)->getDataString());
+}
+
+TEST_CASE("ELFFile from memory", "[libelfpp]") {
+  std::ifstream input("fibonacci", std::ios::binary);
+  auto image = std::make_shared<std::string>((std::istreambuf_iterator<char>(input)),
+                                             std::istreambuf_iterator<char>());
+  REQUIRE_THROWS_AS(ELFFile(image->data(), 10), std::runtime_error);
+  REQUIRE_THROWS_AS(ELFFile(nullptr, 10), std::runtime_error);
+
+  ELFFile read("fibonacci");
+  ELFFile memory(image->data(), image->size(), image, "fibonacci");
+  REQUIRE(memory == read);
+  REQUIRE(memory.sections().size() == read.sections().size());
+  for (size_t i = 0; i < read.sections().size(); ++i) {
+    REQUIRE(memory.sections()[i]->getDataString() == read.sections()[i]->getDataString());
+  }
+  REQUIRE(memory.getNeededLibraries() == read.getNeededLibraries());
+  REQUIRE(memory.relocationSections()[0]->getEntry(1)->SymbolInstance->name == "__libc_start_main");
+  REQUIRE(memory.noteSections()[1]->getEntry(0)->Description ==
+          read.noteSections()[1]->getEntry(0)->Description);
+
+  // section data must be views into the buffer, not copies
+  const char* data = memory.sections()[22]->getData();
+  REQUIRE(data == image->data() + memory.sections()[22]->getOffset());
+
+  // the handle keeps the buffer alive
+  const std::string text = memory.sections()[13]->getDataString();
+  auto section = memory.sections()[13];
+  image.reset();
+  REQUIRE(section->getDataString() == text);
+}
+
 ELFFile file("libelfpp.so");
 
+TEST_CASE("Corpus loader", "[libelfpp]") {
+  std::vector<std::string> paths = {"libelfpp.so", "no_such_file", "fibonacci", "CMakeCache.txt",
+                                    "hello_world", "example_lib.o", "libexamplelib.so",
+                                    "librelrlib.so", "libversionedlib.so"};
+  CorpusOptions options;
+  options.Threads = 3;
+  options.MaxInFlight = 2;
+  CorpusLoader loader(options);
+
+  std::vector<int> seen(paths.size(), 0);
+  const auto caller = std::this_thread::get_id();
+  loader.load(paths, [&](const CorpusResult& result) {
+    REQUIRE(std::this_thread::get_id() == caller);
+    REQUIRE(result.Index < paths.size());
+    REQUIRE(result.Path == paths[result.Index]);
+    ++seen[result.Index];
+    if (result.Path == "no_such_file" || result.Path == "CMakeCache.txt") {
+      REQUIRE_FALSE(result);
+      REQUIRE_FALSE(result.Error.empty());
+    } else {
+      REQUIRE(result);
+      REQUIRE(result.Error.empty());
+      REQUIRE(result.File->sections().size() == ELFFile(result.Path).sections().size());
+    }
+  });
+  REQUIRE(std::all_of(seen.begin(), seen.end(), [](int count) { return count == 1; }));
+
+  // an exception of the callback stops the batch
+  std::size_t calls = 0;
+  REQUIRE_THROWS_AS(loader.load(paths, [&](const CorpusResult&) {
+    ++calls;
+    throw std::logic_error("stop");
+  }), std::logic_error);
+  REQUIRE(calls == 1);
+
+  auto files = CorpusLoader::findFiles(".");
+  REQUIRE(std::is_sorted(files.begin(), files.end()));
+  REQUIRE(std::find(files.begin(), files.end(), "./libelfpp.so") != files.end());
+  REQUIRE(std::find(files.begin(), files.end(), "./CMakeFiles/Makefile.cmake") != files.end());
+  REQUIRE_THROWS_AS(CorpusLoader::findFiles("no_such_directory"), std::runtime_error);
+
+  std::size_t loaded = 0;
+  CorpusLoader().loadDirectory(".", [&](const CorpusResult& result) {
+    loaded += result ? 1 : 0;
+  });
+  REQUIRE(loaded >= paths.size() - 2);
+}
+
+TEST_CASE("Concurrent reads", "[libelfpp]") {
+  // expected results from an instance used by a single thread
+  ELFFile reference("libelfpp.so");
+  std::vector<Elf64_Addr> addresses;
+  std::vector<std::string> names;
+  for (const auto& entry : reference.getAddressIndex()->getEntries()) {
+    if (addresses.size() < 2000 && entry.Symbol.bind == STB_GLOBAL) {
+      addresses.push_back(entry.Symbol.value);
+      names.push_back(entry.Symbol.name.str());
+    }
+  }
+  const auto needed = reference.getNeededLibraries();
+  const auto dynamicCount = reference.getDynamicSection()->entries().size();
+  const auto versionCount = reference.getSymbolVersionTable()->getVersions().size();
+
+  for (auto mode : {LoadMode::Read, LoadMode::Lazy}) {
+    // every round starts with a new instance, so the lazy indexes are built
+    // while other threads use them
+    for (int round = 0; round < 5; ++round) {
+      ELFFile file("libelfpp.so", mode);
+      std::atomic<bool> started(false);
+      std::atomic<int> failures(0);
+      std::vector<std::thread> threads;
+      for (unsigned int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+          while (!started) {
+            std::this_thread::yield();
+          }
+          for (std::size_t i = t; i < addresses.size(); i += 8) {
+            auto found = file.getAddressIndex()->find(addresses[i]);
+            if (!found || found->Symbol.value != addresses[i])
+              ++failures;
+            if (file.getNameIndex()->find(names[i]).empty())
+              ++failures;
+          }
+          if (file.getNeededLibraries() != needed)
+            ++failures;
+          if (file.getDynamicSection()->entries().size() != dynamicCount ||
+              !file.getDynamicSection()->findEntry(DT_SONAME))
+            ++failures;
+          if (file.getSymbolVersionTable()->getVersions().size() != versionCount)
+            ++failures;
+          if (!file.findDynamicSymbol(names[t]))
+            ++failures;
+          for (const auto& section : file.symbolSections()) {
+            auto strings = section->getStringSection();
+            strings->scanStrings();
+            if (section->getResolvedSymbols()->size() != section->symbols().size() ||
+                !strings->isSameString(1, 1))
+              ++failures;
+          }
+          for (const auto& section : file.relocationSections()) {
+            if (section->getAllEntries().size() != section->getNumEntries())
+              ++failures;
+          }
+          for (const auto& section : file.noteSections()) {
+            if (section->getAllEntries().size() != section->getNumEntries())
+              ++failures;
+          }
+          auto bss = file.getSectionByName(".bss");
+          if (!bss || !file.getDataAtAddress(bss->getAddress(), bss->getSize()))
+            ++failures;
+        });
+      }
+      started = true;
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      REQUIRE(failures == 0);
+    }
+  }
+}
+
+TEST_CASE("File cache", "[libelfpp]") {
+  auto fileSize = [](const char* name) {
+    std::ifstream stream(name, std::ios::binary | std::ios::ate);
+    return static_cast<Elf64_Xword>(stream.tellg());
+  };
+  ELFFileCache cache(fileSize("fibonacci") + fileSize("hello_world"));
+
+  auto fibonacci = cache.get("fibonacci");
+  REQUIRE(fibonacci != nullptr);
+  REQUIRE(cache.get("./fibonacci") == fibonacci);
+  auto hello = cache.get("hello_world");
+  REQUIRE(cache.get("fibonacci") == fibonacci);
+  auto stats = cache.getStatistics();
+  REQUIRE(stats.Hits == 2);
+  REQUIRE(stats.Misses == 2);
+  REQUIRE(stats.Entries == 2);
+  REQUIRE(stats.Bytes == cache.getByteBudget());
+
+  // hello_world is the least recently used file
+  auto object = cache.get("example_lib.o");
+  stats = cache.getStatistics();
+  REQUIRE(stats.Evictions == 1);
+  REQUIRE(stats.Entries == 2);
+  REQUIRE(cache.get("fibonacci") == fibonacci);
+  REQUIRE(cache.get("hello_world") != hello);
+  REQUIRE(hello->getHeader()->getELFType() == ET_EXEC);
+
+  // files larger than the budget are loaded but not cached
+  auto large = cache.get("libelfpp.so");
+  REQUIRE(cache.get("libelfpp.so") != large);
+  REQUIRE(cache.getStatistics().Bytes <= cache.getByteBudget());
+
+  // a modified file is loaded again
+  {
+    std::ifstream in("hello_world", std::ios::binary);
+    std::ofstream out("hello_world_copy", std::ios::binary);
+    out << in.rdbuf();
+  }
+  auto copy = cache.get("hello_world_copy");
+  REQUIRE(cache.get("hello_world_copy") == copy);
+  {
+    std::ofstream out("hello_world_copy", std::ios::binary | std::ios::app);
+    out << '\0';
+  }
+  REQUIRE(cache.get("hello_world_copy") != copy);
+  std::remove("hello_world_copy");
+
+  cache.setByteBudget(0);
+  stats = cache.getStatistics();
+  REQUIRE(stats.Entries == 0);
+  REQUIRE(stats.Bytes == 0);
+  REQUIRE_THROWS_AS(cache.get("no_such_file"), std::runtime_error);
+
+  REQUIRE(&ELFFileCache::getGlobal() == &ELFFileCache::getGlobal());
+  REQUIRE(ELFFileCache::getGlobal().get("fibonacci") == ELFFileCache::getGlobal().get("fibonacci"));
+}
+
+TEST_CASE("Metadata snapshot", "[libelfpp]") {
+  const FileIdentity identity = FileIdentity::fromPath("libelfpp.so");
+  ELFFile lib("libelfpp.so");
+  REQUIRE(MetadataSnapshot::write(lib, identity, "libelfpp.so.snapshot"));
+  auto snapshot = MetadataSnapshot::open("libelfpp.so.snapshot", "libelfpp.so");
+  REQUIRE(snapshot != nullptr);
+  REQUIRE(snapshot->getSourceIdentity() == FileIdentity::fromPath("libelfpp.so"));
+  REQUIRE(snapshot->getFileInfo().Type == lib.getHeader()->getELFType());
+  REQUIRE(snapshot->getFileInfo().Machine == lib.getHeader()->getMachine());
+  REQUIRE((snapshot->getFileInfo().Is64Bit != 0) == lib.getHeader()->is64Bit());
+
+  REQUIRE(snapshot->getSections().size() == lib.sections().size());
+  for (const auto& sec : lib.sections()) {
+    const auto& record = snapshot->getSections()[sec->getIndex()];
+    REQUIRE(snapshot->getName(record) == sec->getName());
+    REQUIRE(record.Type == sec->getType());
+    REQUIRE(record.Offset == sec->getOffset());
+    REQUIRE(record.Size == sec->getSize());
+  }
+  REQUIRE(snapshot->findSection(".dynsym") == &snapshot->getSections()[lib.getSectionByName(".dynsym")->getIndex()]);
+  REQUIRE(snapshot->findSection(".no_such_section") == nullptr);
+
+  REQUIRE(snapshot->getSegments().size() == lib.segments().size());
+  for (std::size_t i = 0; i < lib.segments().size(); ++i) {
+    const auto& record = snapshot->getSegments()[i];
+    const auto& associated = lib.segments()[i]->getAssociatedSections();
+    REQUIRE(record.VirtualAddress == lib.segments()[i]->getVirtualAddress());
+    REQUIRE(record.MemorySize == lib.segments()[i]->getMemorySize());
+    auto sections = snapshot->getSectionsOfSegment(record);
+    REQUIRE(sections.size() == associated.size());
+    for (std::size_t j = 0; j < associated.size(); ++j)
+      REQUIRE(sections[j] == associated[j]->getIndex());
+  }
+
+  // lookups give the same results as the indexes of the file
+  auto addressIndex = lib.getAddressIndex();
+  REQUIRE(snapshot->getSymbols().size() == addressIndex->getEntries().size());
+  REQUIRE_FALSE(snapshot->getSymbols().empty());
+  for (const auto& entry : addressIndex->getEntries()) {
+    const Elf64_Addr address = entry.Symbol.value + entry.Symbol.size / 2;
+    auto expected = addressIndex->find(address);
+    auto found = snapshot->findSymbol(address);
+    REQUIRE(found != nullptr);
+    REQUIRE(snapshot->getName(*found) == expected->Symbol.name);
+    REQUIRE(found->SymbolIndex == expected->SymbolIndex);
+
+    auto byName = snapshot->findSymbols(entry.Symbol.name);
+    REQUIRE(std::any_of(byName.begin(), byName.end(), [&](const SnapshotSymbol* symbol) {
+      return symbol->Value == entry.Symbol.value && symbol->SymbolIndex == entry.SymbolIndex;
+    }));
+  }
+  REQUIRE(snapshot->findSymbols("no_such_symbol").empty());
+
+  // nested symbols give the same results as the address index
+  {
+    std::ofstream out("nested_symbols.o", std::ios::binary);
+    out << makeSymbolImage({{"outer", 0x1000, 0x100}, {"inner", 0x1010, 0x10},
+                            {"middle", 0x1020, 0x40}, {"innermost", 0x1030, 0x8}});
+  }
+  auto nested = MetadataSnapshot::openOrCreate("nested_symbols.o.snapshot", "nested_symbols.o");
+  REQUIRE(nested != nullptr);
+  auto nestedIndex = ELFFile("nested_symbols.o").getAddressIndex();
+  for (Elf64_Addr address = 0xff0; address < 0x1110; ++address) {
+    auto expected = nestedIndex->find(address);
+    auto found = nested->findSymbol(address);
+    REQUIRE((found == nullptr) == (expected == nullptr));
+    if (found)
+      REQUIRE(nested->getName(*found) == expected->Symbol.name);
+  }
+  REQUIRE(nested->getName(*nested->findSymbol(0x1080)) == "outer");
+
+  // concurrent writers of the same snapshot each write a complete file
+  std::remove("nested_symbols.o.snapshot");
+  const FileIdentity nestedIdentity = FileIdentity::fromPath("nested_symbols.o");
+  const ELFFile nestedFile("nested_symbols.o");
+  std::vector<std::thread> writers;
+  std::atomic<int> opened(0);
+  for (int i = 0; i < 8; ++i) {
+    writers.emplace_back([&]() {
+      if (MetadataSnapshot::openOrCreate("nested_symbols.o.snapshot", "nested_symbols.o"))
+        ++opened;
+      for (int j = 0; j < 10; ++j) {
+        if (MetadataSnapshot::write(nestedFile, nestedIdentity, "nested_symbols.o.snapshot") &&
+            MetadataSnapshot::open("nested_symbols.o.snapshot", "nested_symbols.o"))
+          ++opened;
+      }
+    });
+  }
+  for (auto& writer : writers)
+    writer.join();
+  REQUIRE(opened == 88);
+  for (const auto& path : CorpusLoader::findFiles(".")) {
+    REQUIRE(path.find("nested_symbols.o.snapshot.") == std::string::npos);
+  }
+  std::remove("nested_symbols.o");
+  std::remove("nested_symbols.o.snapshot");
+
+  std::vector<std::string> needed;
+  for (const auto& entry : snapshot->getDynamicEntries()) {
+    if (entry.Tag == DT_NEEDED)
+      needed.push_back(snapshot->getName(entry).str());
+  }
+  REQUIRE(needed == lib.getNeededLibraries());
+  auto soname = snapshot->findDynamicEntry(DT_SONAME);
+  REQUIRE(soname != nullptr);
+  REQUIRE(snapshot->getName(*soname) ==
+          lib.getDynamicSection()->getStringSection()->getString(
+              static_cast<Elf64_Word>(lib.getDynamicSection()->findEntry(DT_SONAME)->value)));
+  REQUIRE(snapshot->findDynamicEntry(DT_NULL) == nullptr);
+
+  std::string buildId;
+  for (const auto& notes : lib.noteSections()) {
+    for (const auto& note : notes->getAllEntries()) {
+      if (note->Type == NT_GNU_BUILD_ID && buildId.empty())
+        buildId = note->Description;
+    }
+  }
+  REQUIRE(std::string(snapshot->getBuildId().begin(), snapshot->getBuildId().end()) == buildId);
+
+  // a snapshot is rejected once the file changed or if it is corrupted
+  {
+    std::ifstream in("hello_world", std::ios::binary);
+    std::ofstream out("hello_world_copy", std::ios::binary);
+    out << in.rdbuf();
+  }
+  auto created = MetadataSnapshot::openOrCreate("hello_world_copy.snapshot", "hello_world_copy");
+  REQUIRE(created != nullptr);
+  REQUIRE(MetadataSnapshot::open("hello_world_copy.snapshot", "hello_world_copy") != nullptr);
+  REQUIRE(MetadataSnapshot::open("hello_world_copy.snapshot", "hello_world") == nullptr);
+  {
+    std::ofstream out("hello_world_copy", std::ios::binary | std::ios::app);
+    out << '\0';
+  }
+  REQUIRE(MetadataSnapshot::open("hello_world_copy.snapshot", "hello_world_copy") == nullptr);
+
+  // metadata of a file that changed after it was loaded is not written
+  const FileIdentity before = FileIdentity::fromPath("hello_world_copy");
+  ELFFile changed("hello_world_copy");
+  {
+    std::ofstream out("hello_world_copy", std::ios::binary | std::ios::app);
+    out << '\0';
+  }
+  REQUIRE_FALSE(MetadataSnapshot::write(changed, before, "hello_world_copy.snapshot"));
+  REQUIRE(MetadataSnapshot::open("hello_world_copy.snapshot", "hello_world_copy") == nullptr);
+  REQUIRE(MetadataSnapshot::openOrCreate("hello_world_copy.snapshot", "hello_world_copy") != nullptr);
+  {
+    std::fstream out("hello_world_copy.snapshot", std::ios::binary | std::ios::in | std::ios::out);
+    out.write("X", 1);
+  }
+  REQUIRE(MetadataSnapshot::open("hello_world_copy.snapshot", "hello_world_copy") == nullptr);
+  REQUIRE(MetadataSnapshot::open("no_such_file.snapshot", "hello_world_copy") == nullptr);
+  std::remove("hello_world_copy");
+  std::remove("hello_world_copy.snapshot");
+  std::remove("libelfpp.so.snapshot");
+}
+
 TEST_CASE("Compare operators", "[libelfpp]") {
   ELFFile test("test_elfpp");
   REQUIRE(test != file);
@@ -127,6 +1221,90 @@ TEST_CASE("Dynamic Section access", "[libelfpp]") {
   REQUIRE_FALSE(file.getNeededLibraries().empty());
 }
 
+TEST_CASE("Dynamic tag lookup", "[libelfpp]") {
+  ELFFile lib("libexamplelib.so");
+  auto dyn = lib.getDynamicSection();
+  REQUIRE(dyn);
+  REQUIRE(&dyn->entries() == &dyn->entries());
+  REQUIRE(dyn->entries().size() == dyn->getNumEntries());
+  REQUIRE(dyn->getAllEntries().size() == dyn->entries().size());
+
+  // the first entry of every tag before DT_NULL is found
+  for (const auto& entry : dyn->entries()) {
+    if (entry.tag == DT_NULL)
+      break;
+    auto found = dyn->findEntry(entry.tag);
+    REQUIRE(found != nullptr);
+    REQUIRE(found->tag == entry.tag);
+    REQUIRE(found <= &entry);
+  }
+  REQUIRE(dyn->findEntry(DT_NULL) == nullptr);
+  REQUIRE(dyn->findEntry(DT_LOPROC) == nullptr);
+
+  auto soname = dyn->findEntry(DT_SONAME);
+  REQUIRE(soname != nullptr);
+  REQUIRE(dyn->getStringSection() != nullptr);
+  REQUIRE(dyn->getStringSection()->getName() == ".dynstr");
+  REQUIRE(dyn->getStringSection()->getStringView(static_cast<Elf64_Word>(soname->value)) == "libexamplelib.so");
+  REQUIRE(dyn->findEntry(DT_NEEDED)->value == dyn->entries()[0].value);
+
+  auto& needed = lib.getNeededLibraries();
+  REQUIRE(&needed == &ELFFile(lib).getNeededLibraries());
+  REQUIRE(needed == std::vector<std::string>({"libstdc++.so.6", "libm.so.6", "libgcc_s.so.1", "libc.so.6"}));
+}
+
+TEST_CASE("Symbol versions", "[libelfpp]") {
+  ELFFile lib("libversionedlib.so");
+  auto versions = lib.getSymbolVersionTable();
+  REQUIRE(versions != nullptr);
+  REQUIRE(versions == lib.getSymbolVersionTable());
+  REQUIRE(versions->size() == versions->getSymbolSection()->symbols().size());
+
+  std::vector<std::string> names;
+  for (auto symbol : *versions) {
+    std::ostringstream name;
+    name << symbol;
+    names.push_back(name.str());
+  }
+  REQUIRE(std::find(names.begin(), names.end(), "getValue@EXAMPLE_1.0") != names.end());
+  REQUIRE(std::find(names.begin(), names.end(), "getValue@@EXAMPLE_2.0") != names.end());
+  REQUIRE(std::find(names.begin(), names.end(), "getBase@@EXAMPLE_1.0") != names.end());
+  REQUIRE(std::find(names.begin(), names.end(), "puts@GLIBC_2.2.5") != names.end());
+  REQUIRE(names[0].empty());
+
+  Elf64_Xword index = 0;
+  for (auto symbol : versions->getSymbolSection()->symbols()) {
+    auto versioned = (*versions)[index];
+    REQUIRE(versioned.Symbol.name == symbol.name);
+    if (symbol.name == "puts") {
+      REQUIRE(versioned.Version == versions->getVersion(index));
+      REQUIRE(versioned.Version->File == "libc.so.6");
+      REQUIRE_FALSE(versioned.Version->IsDefinition);
+      REQUIRE_FALSE(versioned.isDefault());
+    }
+    if (symbol.name == "getValue") {
+      REQUIRE(versioned.IsHidden == (versioned.Version->Name == "EXAMPLE_1.0"));
+      REQUIRE(versioned.isDefault() == (versioned.Version->Name == "EXAMPLE_2.0"));
+      REQUIRE(versioned.Version->File.empty());
+    }
+    ++index;
+  }
+  REQUIRE(versions->getVersionIndex(0) == VER_NDX_LOCAL);
+  REQUIRE(versions->getVersion(0) == nullptr);
+  REQUIRE(versions->getVersionIndex(versions->size()) == VER_NDX_GLOBAL);
+  REQUIRE(versions->findVersion(VER_NDX_GLOBAL) == nullptr);
+
+  // base definition, two defined and one required version
+  REQUIRE(versions->getVersions().size() == 4);
+  REQUIRE(versions->getVersions()[0].Flags == VER_FLG_BASE);
+  REQUIRE(versions->getVersions()[0].Name == "libversionedlib.so");
+  for (const auto& version : versions->getVersions()) {
+    REQUIRE(version.Hash == SymbolHashTable::sysvHash(version.Name));
+  }
+
+  REQUIRE(ELFFile("example_lib.o").getSymbolVersionTable() == nullptr);
+}
+
 TEST_CASE("Symbol access", "[libelfpp]") {
   REQUIRE(file.symbolSections().size() > 0);
 
@@ -165,6 +1343,167 @@ TEST_CASE("Relocation access", "[libelfpp]") {
   REQUIRE(entry->Info);
 }
 
+TEST_CASE("Shared symbol and string sections", "[libelfpp]") {
+  for (const char* name : {"example_lib.o", "libelfpp.so"}) {
+    ELFFile object(name);
+    auto relocs = object.relocationSections();
+    REQUIRE(relocs.size() > 1);
+    for (const auto& reloc : relocs) {
+      auto symbols = reloc->getSymbolSection();
+      REQUIRE(symbols == relocs[0]->getSymbolSection());
+      REQUIRE(symbols->getIndex() == reloc->getLink());
+      REQUIRE(std::find(object.symbolSections().begin(), object.symbolSections().end(), symbols) !=
+              object.symbolSections().end());
+      REQUIRE_FALSE(symbols->getName().empty());
+      REQUIRE(symbols->getStringSection()->getIndex() == symbols->getLink());
+      REQUIRE_FALSE(symbols->getStringSection()->getName().empty());
+    }
+  }
+}
+
+TEST_CASE("Batch relocation decoding", "[libelfpp]") {
+  for (const char* name : {"example_lib.o", "libelfpp.so"}) {
+    ELFFile object(name);
+    for (const auto& reloc : object.relocationSections()) {
+      auto records = reloc->getAllRecords();
+      auto entries = reloc->getAllEntries();
+      REQUIRE(records.size() == reloc->getNumEntries());
+      REQUIRE(entries.size() == records.size());
+
+      auto symbols = reloc->getSymbolSection()->getResolvedSymbols();
+      REQUIRE(symbols == reloc->getSymbolSection()->getResolvedSymbols());
+      REQUIRE(symbols->size() == reloc->getSymbolSection()->getNumSymbols());
+      for (size_t i = 0; i < records.size(); ++i) {
+        auto entry = reloc->getEntry(i);
+        REQUIRE(records[i].Offset == entry->Offset);
+        REQUIRE(records[i].Info == entry->Info);
+        REQUIRE(records[i].Addend == entry->Addend);
+        REQUIRE(records[i].SymbolIndex == entry->SymbolIndex);
+        REQUIRE(records[i].Type == entry->Type);
+        REQUIRE(entries[i]->Offset == entry->Offset);
+        REQUIRE(entries[i]->SymbolInstance->name == entry->SymbolInstance->name);
+        REQUIRE((*symbols)[records[i].SymbolIndex].name == entry->SymbolInstance->name);
+        REQUIRE((*symbols)[records[i].SymbolIndex].value == entry->SymbolInstance->value);
+      }
+
+      // relocations against the same symbol share its instance
+      for (size_t i = 1; i < entries.size(); ++i) {
+        if (entries[i]->SymbolIndex == entries[0]->SymbolIndex)
+          REQUIRE(entries[i]->SymbolInstance == entries[0]->SymbolInstance);
+      }
+
+      // decoding into a buffer stops at the end of the section
+      std::vector<RelocationRecord> buffer(4);
+      Elf64_Xword first = records.size() > 2 ? records.size() - 2 : 0;
+      Elf64_Xword decoded = reloc->decodeRecords(first, buffer.size(), buffer.data());
+      REQUIRE(decoded == records.size() - first);
+      for (Elf64_Xword i = 0; i < decoded; ++i) {
+        REQUIRE(buffer[i].Offset == records[first + i].Offset);
+      }
+      REQUIRE(reloc->decodeRecords(records.size(), 1, buffer.data()) == 0);
+    }
+  }
+}
+
+TEST_CASE("Parallel decoding", "[libelfpp]") {
+  for (auto mode : {LoadMode::Read, LoadMode::Lazy}) {
+    ELFFile file("libelfpp.so", mode);
+    for (const auto& section : file.symbolSections()) {
+      auto range = section->symbols();
+      std::vector<SymbolRef> serial(range.begin(), range.end());
+      for (unsigned int threads : {0u, 1u, 3u, 8u}) {
+        auto parallel = section->decodeAllSymbols(threads);
+        REQUIRE(parallel.size() == serial.size());
+        for (std::size_t i = 0; i < serial.size(); ++i) {
+          REQUIRE(parallel[i].name == serial[i].name);
+          REQUIRE(parallel[i].value == serial[i].value);
+          REQUIRE(parallel[i].size == serial[i].size);
+          REQUIRE(parallel[i].sectionIndex == serial[i].sectionIndex);
+        }
+      }
+      SymbolRef last;
+      REQUIRE(section->decodeSymbols(serial.size() - 1, 10, &last) == 1);
+      REQUIRE(last.name == serial.back().name);
+      REQUIRE(section->decodeSymbols(serial.size(), 1, &last) == 0);
+    }
+
+    for (const auto& section : file.relocationSections()) {
+      auto serial = section->getAllRecords();
+      for (unsigned int threads : {0u, 1u, 3u, 8u}) {
+        auto parallel = section->decodeAllRecords(threads);
+        REQUIRE(parallel.size() == serial.size());
+        REQUIRE(std::equal(parallel.begin(), parallel.end(), serial.begin(),
+                           [](const RelocationRecord& lhs, const RelocationRecord& rhs) {
+          return lhs.Offset == rhs.Offset && lhs.Info == rhs.Info && lhs.Addend == rhs.Addend;
+        }));
+      }
+    }
+  }
+
+  auto relr = ELFFile("librelrlib.so").relocationSections();
+  for (const auto& section : relr) {
+    REQUIRE(section->decodeAllRecords(4).size() == section->getAllRecords().size());
+  }
+}
+
+TEST_CASE("Packed relative relocations", "[libelfpp]") {
+  EndianessConverter converter(true, true);
+  const uint64_t words64[] = {0x1000, 1 | 2 | 8 | (uint64_t(1) << 63), 1 | 2, 0x3000};
+  RelrRange range64(reinterpret_cast<const char*>(words64), sizeof(words64), 8, converter);
+  const std::vector<Elf64_Addr> expected64 = {0x1000, 0x1008, 0x1018, 0x11F8, 0x1200, 0x3000};
+  REQUIRE(range64.count() == expected64.size());
+  REQUIRE(std::vector<Elf64_Addr>(range64.begin(), range64.end()) == expected64);
+  std::vector<Elf64_Addr> buffer(expected64.size());
+  REQUIRE(range64.expand(buffer.data(), buffer.size()) == expected64.size());
+  REQUIRE(buffer == expected64);
+  REQUIRE(range64.expand(buffer.data(), 3) == 3);
+
+  const uint32_t words32[] = {0x100, 1 | (uint32_t(1) << 31)};
+  RelrRange range32(reinterpret_cast<const char*>(words32), sizeof(words32), 4, converter);
+  REQUIRE(std::vector<Elf64_Addr>(range32.begin(), range32.end()) == std::vector<Elf64_Addr>({0x100, 0x17C}));
+  REQUIRE(RelrRange(nullptr, 0, 8, converter).begin() == RelrRange(nullptr, 0, 8, converter).end());
+
+  ELFFile lib("librelrlib.so");
+  std::shared_ptr<RelrSection> relr;
+  for (const auto& reloc : lib.relocationSections()) {
+    if (reloc->getType() == SHT_RELR)
+      relr = std::dynamic_pointer_cast<RelrSection>(reloc);
+  }
+  if (!relr) {
+    WARN("The linker does not support -z pack-relative-relocs");
+    return;
+  }
+  REQUIRE(relr->getTypeString() == "RELR");
+  REQUIRE(relr->getSymbolSection() == nullptr);
+
+  auto offsets = relr->offsets();
+  std::vector<Elf64_Addr> expanded(offsets.begin(), offsets.end());
+  REQUIRE(expanded.size() == offsets.count());
+  REQUIRE(expanded.size() == relr->getNumEntries());
+  REQUIRE(std::is_sorted(expanded.begin(), expanded.end()));
+
+  auto pointers = lib.findDynamicSymbol("Pointers");
+  REQUIRE(pointers);
+  REQUIRE(pointers.Symbol.size == 70 * 8);
+  for (Elf64_Addr offset = pointers.Symbol.value; offset < pointers.Symbol.value + 70 * 8; offset += 8) {
+    REQUIRE(std::binary_search(expanded.begin(), expanded.end(), offset));
+  }
+  auto sparse = lib.findDynamicSymbol("Sparse");
+  REQUIRE(sparse);
+  for (Elf64_Addr i = 0; i < 12; ++i) {
+    REQUIRE(std::binary_search(expanded.begin(), expanded.end(), sparse.Symbol.value + i * 8) == (i % 3 == 0));
+  }
+
+  auto entries = relr->getAllEntries();
+  REQUIRE(entries.size() == expanded.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    REQUIRE(entries[i]->Offset == expanded[i]);
+    REQUIRE(entries[i]->Type == R_X86_64_RELATIVE);
+    REQUIRE(entries[i]->SymbolInstance->name.empty());
+  }
+  REQUIRE(relr->getEntry(expanded.size()) == nullptr);
+}
+
 TEST_CASE("Note section access", "[libelfpp]") {
   auto notes = file.noteSections();
   REQUIRE(notes.size() > 0);
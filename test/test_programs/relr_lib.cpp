@@ -0,0 +1,48 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2017 Kevin Kirchner
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Tables of pointers to local data. Linked with -z pack-relative-relocs, their
+// relative relocations are packed into bitmaps of a .relr.dyn section.
+
+static int Values[70];
+
+int* Pointers[70] = {
+    &Values[0], &Values[1], &Values[2], &Values[3], &Values[4], &Values[5],
+    &Values[6], &Values[7], &Values[8], &Values[9], &Values[10], &Values[11],
+    &Values[12], &Values[13], &Values[14], &Values[15], &Values[16], &Values[17],
+    &Values[18], &Values[19], &Values[20], &Values[21], &Values[22], &Values[23],
+    &Values[24], &Values[25], &Values[26], &Values[27], &Values[28], &Values[29],
+    &Values[30], &Values[31], &Values[32], &Values[33], &Values[34], &Values[35],
+    &Values[36], &Values[37], &Values[38], &Values[39], &Values[40], &Values[41],
+    &Values[42], &Values[43], &Values[44], &Values[45], &Values[46], &Values[47],
+    &Values[48], &Values[49], &Values[50], &Values[51], &Values[52], &Values[53],
+    &Values[54], &Values[55], &Values[56], &Values[57], &Values[58], &Values[59],
+    &Values[60], &Values[61], &Values[62], &Values[63], &Values[64], &Values[65],
+    &Values[66], &Values[67], &Values[68], &Values[69]
+};
+
+int* Sparse[12] = {
+    &Values[0], nullptr, nullptr, &Values[3], nullptr, nullptr,
+    &Values[6], nullptr, nullptr, &Values[9], nullptr, nullptr
+};